@@ -0,0 +1,52 @@
+#include "benchmark/benchmark.h"
+
+#include "checkpoint.hpp"
+#include "simulation.hpp"
+
+#include <sstream>
+#include <string>
+
+// Warstwowa siec `workers` robotnikow po kilka polaczen na robotnika, po kilkudziesieciu turach symulacji.
+static std::string make_layered_structure(int workers) {
+    std::ostringstream os;
+    os << "LOADING_RAMP id=1 delivery-interval=1\n";
+    for (int id = 1; id <= workers; ++id) {
+        os << "WORKER id=" << id << " processing-time=" << (id % 3 + 1) << " queue-type=FIFO\n";
+    }
+    os << "STOREHOUSE id=1\n";
+    os << "LINK src=ramp-1 dest=worker-1\n";
+    for (int id = 1; id <= workers; ++id) {
+        os << "LINK src=worker-" << id << " dest=store-1\n";
+        for (int k = 1; k < 4 && id + k <= workers; ++k) {
+            os << "LINK src=worker-" << id << " dest=worker-" << id + k << "\n";
+        }
+    }
+    return os.str();
+}
+
+static void BM_ParseStructure(benchmark::State& state) {
+    const std::string structure = make_layered_structure(static_cast<int>(state.range(0)));
+    for (auto _: state) {
+        std::istringstream is(structure);
+        benchmark::DoNotOptimize(load_factory_structure(is));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(structure.size()));
+}
+BENCHMARK(BM_ParseStructure)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_LoadCheckpoint(benchmark::State& state) {
+    std::istringstream structure(make_layered_structure(static_cast<int>(state.range(0))));
+    Factory factory = load_factory_structure(structure);
+    factory.seed_streams(1);
+    simulate(factory, 50, [](Factory&, Time) {});
+    std::ostringstream os;
+    save_checkpoint(factory, 49, os);
+    const std::string snapshot = os.str();
+
+    for (auto _: state) {
+        std::istringstream is(snapshot);
+        benchmark::DoNotOptimize(load_checkpoint(is));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(snapshot.size()));
+}
+BENCHMARK(BM_LoadCheckpoint)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,70 @@
+#include "benchmark/benchmark.h"
+
+#include "compiled_factory.hpp"
+
+#include <cstdint>
+#include <memory>
+
+// `workers` robotnikow, rampy co 100 robotnikow dostarczajace w kazdej turze; kazdy robotnik oddaje do magazynu
+// i do trzech losowych robotnikow o wiekszym ID, wiec polprodukty kraza po calej sieci.
+static Factory make_mesh_factory(ElementID workers) {
+    Factory factory;
+    factory.add_storehouse(Storehouse(1));
+    for (ElementID id = 1; id <= workers; ++id) {
+        factory.add_worker(Worker(id, 2, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    }
+    std::uint64_t lcg = 2021;
+    auto next = [&lcg](ElementID bound) {
+        lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<ElementID>((lcg >> 33) % static_cast<std::uint64_t>(bound));
+    };
+    for (ElementID id = 1; id <= workers; id += 100) {
+        factory.add_ramp(Ramp(id, 1));
+        factory.find_ramp_by_id(id)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(id));
+    }
+    for (ElementID id = 1; id <= workers; ++id) {
+        auto& preferences = factory.find_worker_by_id(id)->receiver_preferences_;
+        preferences.add_receiver_deferred(&*factory.find_storehouse_by_id(1));
+        for (int k = 0; k < 3 and id < workers; ++k) {
+            preferences.add_receiver_deferred(&*factory.find_worker_by_id(id + 1 + next(workers - id)));
+        }
+        preferences.rebuild();
+    }
+    return factory;
+}
+
+static void BM_TurnFactory(benchmark::State& state) {
+    Factory factory = make_mesh_factory(static_cast<ElementID>(state.range(0)));
+    Time t = 1;
+    for (auto _: state) {
+        factory.do_deliveries(t);
+        factory.do_package_passing();
+        factory.do_work(t);
+        t++;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TurnFactory)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_TurnCompiled(benchmark::State& state) {
+    Factory factory = make_mesh_factory(static_cast<ElementID>(state.range(0)));
+    CompiledFactory compiled(factory);
+    Time t = 1;
+    for (auto _: state) {
+        compiled.do_deliveries(t);
+        compiled.do_package_passing();
+        compiled.do_work(t);
+        t++;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_TurnCompiled)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_CompileFactory(benchmark::State& state) {
+    Factory factory = make_mesh_factory(static_cast<ElementID>(state.range(0)));
+    for (auto _: state) {
+        CompiledFactory compiled(factory);
+        benchmark::DoNotOptimize(compiled);
+    }
+}
+BENCHMARK(BM_CompileFactory)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,104 @@
+#include "benchmark/benchmark.h"
+
+#include "factory.hpp"
+
+#include <sstream>
+#include <string>
+
+// Struktura z jedna rampa, `workers` robotnikami i `links` polaczeniami:
+// kazdy robotnik wysyla do kilku kolejnych robotnikow, ostatnie warstwy do magazynu.
+static std::string make_structure(int workers, int links) {
+    std::ostringstream os;
+    os << "LOADING_RAMP id=1 delivery-interval=1\n";
+    for (int id = 1; id <= workers; ++id) {
+        os << "WORKER id=" << id << " processing-time=1 queue-type=" << (id % 2 ? "FIFO" : "LIFO") << "\n";
+    }
+    os << "STOREHOUSE id=1\n";
+    os << "LINK src=ramp-1 dest=worker-1\n";
+    int fan_out = std::max(1, (links - 1) / workers);
+    for (int id = 1; id <= workers; ++id) {
+        os << "LINK src=worker-" << id << " dest=store-1\n";
+        for (int k = 1; k < fan_out && id + k <= workers; ++k) {
+            os << "LINK src=worker-" << id << " dest=worker-" << id + k << "\n";
+        }
+    }
+    return os.str();
+}
+
+static void BM_LoadFactoryStructure(benchmark::State& state) {
+    const std::string structure = make_structure(static_cast<int>(state.range(0)), static_cast<int>(state.range(1)));
+    for (auto _: state) {
+        std::istringstream is(structure);
+        Factory factory = load_factory_structure(is);
+        benchmark::DoNotOptimize(factory.worker_cbegin());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(structure.size()));
+}
+BENCHMARK(BM_LoadFactoryStructure)->Args({1000, 10000})->Args({10000, 100000})->Args({100000, 1000000})
+    ->Unit(benchmark::kMillisecond)->Iterations(1);
+
+static void BM_FindWorkerById(benchmark::State& state) {
+    const auto n = static_cast<ElementID>(state.range(0));
+    Factory factory;
+    for (ElementID id = 1; id <= n; ++id) {
+        factory.add_worker(Worker(id, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    }
+    ElementID id = 1;
+    for (auto _: state) {
+        id = id % n + 1;
+        benchmark::DoNotOptimize(factory.find_worker_by_id(id));
+    }
+}
+BENCHMARK(BM_FindWorkerById)->RangeMultiplier(10)->Range(100, 100000);
+
+// Losowy graf: `workers` robotnikow po `links / workers` polaczen, kazdy robotnik ma tez wyjscie do magazynu.
+static Factory make_random_factory(ElementID workers, ElementID links) {
+    const auto fan_out = links / workers;
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_storehouse(Storehouse(1));
+    for (ElementID id = 1; id <= workers; ++id) {
+        factory.add_worker(Worker(id, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    }
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1));
+    std::uint64_t state_lcg = 2021;
+    for (auto it = factory.worker_begin(); it != factory.worker_end(); ++it) {
+        auto& preferences = it->receiver_preferences_;
+        preferences.add_receiver_deferred(&*factory.find_storehouse_by_id(1));
+        for (ElementID k = 1; k < fan_out; ++k) {
+            state_lcg = state_lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+            auto target = static_cast<ElementID>((state_lcg >> 33) % static_cast<std::uint64_t>(workers)) + 1;
+            preferences.add_receiver_deferred(&*factory.find_worker_by_id(target));
+        }
+        preferences.rebuild();
+    }
+    return factory;
+}
+
+// Pelne sprawdzenie z lista winowajcow
+static void BM_CheckConsistency(benchmark::State& state) {
+    Factory factory = make_random_factory(static_cast<ElementID>(state.range(0)), static_cast<ElementID>(state.range(1)));
+    for (auto _: state) {
+        benchmark::DoNotOptimize(factory.check_consistency());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_CheckConsistency)->Args({10000, 100000})->Args({100000, 1000000})->Args({1000000, 10000000})
+    ->Unit(benchmark::kMillisecond);
+
+// Edycja miedzy oknami symulacji: nowy robotnik wpiety w siec i usuniety, po kazdej zmianie werdykt
+static void BM_IsConsistentAfterEdit(benchmark::State& state) {
+    const auto workers = static_cast<ElementID>(state.range(0));
+    Factory factory = make_random_factory(workers, workers * 10);
+    const ElementID added = workers + 1;
+    for (auto _: state) {
+        factory.add_worker(Worker(added, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+        Worker& worker = *factory.find_worker_by_id(added);
+        factory.find_worker_by_id(workers / 2)->receiver_preferences_.add_receiver(&worker);
+        worker.receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1));
+        benchmark::DoNotOptimize(factory.is_consistent());
+        factory.remove_worker(added);
+        benchmark::DoNotOptimize(factory.is_consistent());
+    }
+}
+BENCHMARK(BM_IsConsistentAfterEdit)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
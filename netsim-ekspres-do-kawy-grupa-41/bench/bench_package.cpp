@@ -0,0 +1,79 @@
+#include "benchmark/benchmark.h"
+
+#include "id_allocator.hpp"
+#include "package.hpp"
+
+#include <set>
+#include <vector>
+
+// Poprzednia implementacja: dwa drzewa czerwono-czarne (przydzielone i zwolnione ID).
+class SetIdBookkeeping {
+public:
+    ElementID allocate() {
+        ElementID id;
+        if (freed_IDs.empty()) {
+            id = assigned_IDs.empty() ? 1 : *assigned_IDs.rbegin() + 1;
+        } else {
+            id = *freed_IDs.begin();
+            freed_IDs.erase(freed_IDs.begin());
+        }
+        assigned_IDs.insert(id);
+        return id;
+    }
+    void release(ElementID id) {
+        assigned_IDs.erase(id);
+        freed_IDs.insert(id);
+    }
+
+private:
+    std::set<ElementID> assigned_IDs;
+    std::set<ElementID> freed_IDs;
+};
+
+// Przy `live` aktywnych ID zwalnia i ponownie przydziela ID rozrzucone po calym zakresie.
+template <class Allocator>
+static void BM_AllocateRelease(benchmark::State& state) {
+    const auto live = static_cast<ElementID>(state.range(0));
+    Allocator allocator;
+    for (ElementID i = 0; i < live; ++i) {
+        allocator.allocate();
+    }
+    ElementID cursor = 1;
+    for (auto _: state) {
+        cursor = (cursor + 7919) % live + 1;
+        allocator.release(cursor);
+        benchmark::DoNotOptimize(allocator.allocate());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_AllocateRelease, IdAllocator)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_AllocateRelease, SetIdBookkeeping)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
+
+// Dokladanie nowych ID az do `live` aktywnych (kazde allocate() trafia na pusta pule zwolnionych).
+template <class Allocator>
+static void BM_AllocateFresh(benchmark::State& state) {
+    const auto live = state.range(0);
+    for (auto _: state) {
+        Allocator allocator;
+        for (std::int64_t i = 0; i < live; ++i) {
+            benchmark::DoNotOptimize(allocator.allocate());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * live);
+}
+BENCHMARK_TEMPLATE(BM_AllocateFresh, IdAllocator)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_AllocateFresh, SetIdBookkeeping)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_PackageConstructDestroy(benchmark::State& state) {
+    std::vector<Package> live;
+    live.reserve(static_cast<std::size_t>(state.range(0)));
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        live.emplace_back();
+    }
+    for (auto _: state) {
+        Package p;
+        benchmark::DoNotOptimize(p.get_id());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_PackageConstructDestroy)->RangeMultiplier(16)->Range(1 << 10, 1 << 22);
@@ -0,0 +1,58 @@
+#include "benchmark/benchmark.h"
+
+#include "factory.hpp"
+#include "thread_pool.hpp"
+
+#include <memory>
+
+// Szeroka siec: `ramps` ramp dostarczajacych co trzy tury, kazda do wlasnego lancucha `depth` robotnikow,
+// ostatni robotnik lancucha oddaje do wspolnego magazynu. Skalowanie tury w zaleznosci od liczby watkow.
+static Factory make_wide_factory(ElementID ramps, ElementID depth) {
+    Factory factory;
+    factory.add_storehouse(Storehouse(1));
+    for (ElementID r = 1; r <= ramps; ++r) {
+        for (ElementID k = 0; k < depth; ++k) {
+            ElementID id = (r - 1) * depth + k + 1;
+            factory.add_worker(Worker(id, 3, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+        }
+    }
+    for (ElementID r = 1; r <= ramps; ++r) {
+        factory.add_ramp(Ramp(r, 3));
+        ElementID first = (r - 1) * depth + 1;
+        factory.find_ramp_by_id(r)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(first));
+        for (ElementID id = first; id < first + depth; ++id) {
+            IPackageReceiver* next = id + 1 < first + depth
+                    ? static_cast<IPackageReceiver*>(&*factory.find_worker_by_id(id + 1))
+                    : static_cast<IPackageReceiver*>(&*factory.find_storehouse_by_id(1));
+            factory.find_worker_by_id(id)->receiver_preferences_.add_receiver(next);
+        }
+    }
+    return factory;
+}
+
+static void BM_TurnSequential(benchmark::State& state) {
+    Factory factory = make_wide_factory(static_cast<ElementID>(state.range(0)), 10);
+    Time t = 1;
+    for (auto _: state) {
+        factory.do_deliveries(t);
+        factory.do_package_passing();
+        factory.do_work(t);
+        t++;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 10);
+}
+BENCHMARK(BM_TurnSequential)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+static void BM_TurnParallel(benchmark::State& state) {
+    Factory factory = make_wide_factory(static_cast<ElementID>(state.range(0)), 10);
+    ThreadPool pool(static_cast<std::size_t>(state.range(1)));
+    Time t = 1;
+    for (auto _: state) {
+        factory.do_deliveries(t, pool);
+        factory.do_package_passing(pool);
+        factory.do_work(t, pool);
+        t++;
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0) * 10);
+}
+BENCHMARK(BM_TurnParallel)->ArgsProduct({{1000, 10000}, {1, 2, 4, 8}})->Unit(benchmark::kMicrosecond)->UseRealTime();
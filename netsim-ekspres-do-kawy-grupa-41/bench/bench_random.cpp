@@ -0,0 +1,58 @@
+#include "benchmark/benchmark.h"
+
+#include "nodes.hpp"
+#include "random.hpp"
+
+#include <random>
+
+static void BM_Mt19937Canonical(benchmark::State& state) {
+    std::mt19937 engine(2021);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(std::generate_canonical<double, 10>(engine));
+    }
+}
+BENCHMARK(BM_Mt19937Canonical);
+
+static void BM_RandomStream(benchmark::State& state) {
+    RandomStream stream(2021);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(stream());
+    }
+}
+BENCHMARK(BM_RandomStream);
+
+// Odbiorcy bez zachowania - liczy sie wylacznie koszt wyboru
+class NullReceiver : public IPackageReceiver {
+public:
+    explicit NullReceiver(ElementID id) : id_(id) {}
+    void receive_package(Package&&) override {}
+    ElementID get_id() const override { return id_; }
+    #if (defined EXERCISE_ID && EXERCISE_ID != EXERCISE_ID_NODES)
+        ReceiverType get_receiver_type() const override { return ReceiverType::WORKER; }
+    #endif
+    IPackageStockpile::const_iterator begin() const override { return {}; }
+    IPackageStockpile::const_iterator cbegin() const override { return {}; }
+    IPackageStockpile::const_iterator end() const override { return {}; }
+    IPackageStockpile::const_iterator cend() const override { return {}; }
+
+private:
+    ElementID id_;
+};
+
+// Wybor sposrod state.range(0) odbiorcow o roznych wagach
+template <class Preferences>
+static void BM_ChooseReceiver(benchmark::State& state) {
+    std::vector<NullReceiver> receivers;
+    for (ElementID id = 1; id <= state.range(0); ++id) {
+        receivers.emplace_back(id);
+    }
+    Preferences preferences(RandomStream(2021));
+    for (auto& receiver: receivers) {
+        preferences.add_receiver(&receiver, static_cast<double>(receiver.get_id()));
+    }
+    for (auto _: state) {
+        benchmark::DoNotOptimize(preferences.choose_receiver());
+    }
+}
+BENCHMARK_TEMPLATE(BM_ChooseReceiver, ReceiverPreferences)->RangeMultiplier(4)->Range(1, 1024);
+BENCHMARK_TEMPLATE(BM_ChooseReceiver, BasicReceiverPreferences<RandomStream>)->RangeMultiplier(4)->Range(1, 1024);
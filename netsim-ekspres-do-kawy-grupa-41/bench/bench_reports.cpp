@@ -0,0 +1,105 @@
+#include "benchmark/benchmark.h"
+
+#include "factory.hpp"
+#include "factory_generator.hpp"
+#include "output_sinks.hpp"
+#include "report_pipeline.hpp"
+#include "simulation.hpp"
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <sstream>
+#include <streambuf>
+
+// Fabryka z `workers` robotnikami, z ktorych kazdy ma w kolejce kilka polproduktow, i jednym pelnym magazynem.
+static Factory make_report_factory(ElementID workers) {
+    Factory factory;
+    factory.add_storehouse(Storehouse(1));
+    for (ElementID id = workers; id >= 1; --id) {
+        factory.add_worker(Worker(id, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+        for (int k = 0; k < 4; ++k) {
+            factory.find_worker_by_id(id)->receive_package(Package(factory.get_context()));
+        }
+    }
+    for (int k = 0; k < 1000; ++k) {
+        factory.find_storehouse_by_id(1)->receive_package(Package(factory.get_context()));
+    }
+    return factory;
+}
+
+static void BM_TurnReport(benchmark::State& state) {
+    Factory factory = make_report_factory(static_cast<ElementID>(state.range(0)));
+    std::ostringstream os;
+    TurnReportWriter writer;
+    Time t = 1;
+    for (auto _: state) {
+        os.str({});
+        writer.write(factory, os, t++);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(os.str().size()));
+}
+BENCHMARK(BM_TurnReport)->RangeMultiplier(10)->Range(100, 10000)->Unit(benchmark::kMicrosecond);
+
+// Ta sama fabryka w formatach do obrobki maszynowej (output_sinks.hpp)
+template <OutputFormat Format>
+static void BM_OutputSink(benchmark::State& state) {
+    Factory factory = make_report_factory(static_cast<ElementID>(state.range(0)));
+    std::ostringstream os;
+    auto sink = make_output_sink(Format, os);
+    Time t = 1;
+    for (auto _: state) {
+        os.str({});
+        sink->write(factory, t++);
+        sink->flush();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(os.str().size()));
+}
+BENCHMARK_TEMPLATE(BM_OutputSink, OutputFormat::JSONL)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_OutputSink, OutputFormat::CSV)->Arg(10000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_OutputSink, OutputFormat::COLUMNAR)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+// Strumien, ktory tylko liczy zapisane znaki
+class CountingBuffer : public std::streambuf {
+public:
+    std::int64_t get_count() const { return count_; }
+
+protected:
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        count_ += n;
+        return n;
+    }
+    int_type overflow(int_type c) override {
+        ++count_;
+        return c;
+    }
+
+private:
+    std::int64_t count_ = 0;
+};
+
+// Symulacja z raportem co ture - formatowanie na watku symulacji albo w potoku (report_pipeline.hpp)
+template <bool Pipelined>
+static void BM_SimulateReported(benchmark::State& state) {
+    FactoryGeneratorOptions options;
+    options.workers = 200;
+    options.storehouses = 5;
+    options.seed = 2021;
+    CountingBuffer buffer;
+    std::ostream os(&buffer);
+    for (auto _: state) {
+        state.PauseTiming();
+        Factory factory = generate_factory(options);
+        state.ResumeTiming();
+        if constexpr (Pipelined) {
+            ReportPipeline pipeline(os, 4);
+            simulate(factory, state.range(0), std::ref(pipeline));
+            pipeline.drain();
+        } else {
+            simulate(factory, state.range(0), [&os](Factory& f, Time t) { generate_simulation_turn_report(f, os, t); });
+        }
+    }
+    state.SetBytesProcessed(buffer.get_count());
+}
+BENCHMARK_TEMPLATE(BM_SimulateReported, false)->Arg(1000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SimulateReported, true)->Arg(1000)->Unit(benchmark::kMillisecond);
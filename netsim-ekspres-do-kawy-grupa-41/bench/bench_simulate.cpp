@@ -0,0 +1,73 @@
+#include "benchmark/benchmark.h"
+
+#include "factory_generator.hpp"
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <memory>
+
+namespace {
+
+constexpr TimeOffset simulated_turns = 50;
+
+// Fabryka o `nodes` wezlach z generatora: 5% ramp, 5% magazynow, reszta robotnikow w 20 warstwach.
+Factory make_generated_factory(ElementID nodes) {
+    FactoryGeneratorOptions options;
+    options.ramps = std::max(1, nodes / 20);
+    options.storehouses = std::max(1, nodes / 20);
+    options.workers = nodes - options.ramps - options.storehouses;
+    options.layers = 20;
+    options.delivery_interval = {2, 6};
+    options.seed = 2021;
+    return generate_factory(options);
+}
+
+}
+
+// Cala symulacja (simulated_turns tur) na swiezo zbudowanej fabryce; budowa i niszczenie poza pomiarem.
+static void BM_Simulate(benchmark::State& state) {
+    const auto nodes = static_cast<ElementID>(state.range(0));
+    for (auto _: state) {
+        state.PauseTiming();
+        auto factory = std::make_unique<Factory>(make_generated_factory(nodes));
+        state.ResumeTiming();
+        simulate(*factory, simulated_turns, [](Factory&, Time) {});
+        state.PauseTiming();
+        factory.reset();
+        state.ResumeTiming();
+    }
+    state.counters["turns"] = benchmark::Counter(static_cast<double>(state.iterations() * (simulated_turns - 1)), benchmark::Counter::kIsRate);
+    state.SetItemsProcessed(state.iterations() * (simulated_turns - 1) * nodes);
+}
+BENCHMARK(BM_Simulate)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Simulate)->Arg(1000000)->Iterations(1)->Unit(benchmark::kMillisecond);
+
+// Siec deterministyczna (jeden odbiorca na nadawce - rampy tyle, ile robotnikow w warstwie), ktora po rozbiegu powtarza sie okresowo - dluga symulacja
+// zwykla i z przeskokiem nad okresami.
+template <bool FastForward>
+static void BM_SimulatePeriodic(benchmark::State& state) {
+    FactoryGeneratorOptions options;
+    options.ramps = 100;
+    options.workers = 1000;
+    options.storehouses = 10;
+    options.fan_out = {1, 1};
+    options.processing_time = {1, 1};
+    options.delivery_interval = {2, 6};
+    options.seed = 2021;
+    const auto turns = static_cast<TimeOffset>(state.range(0));
+    for (auto _: state) {
+        state.PauseTiming();
+        auto factory = std::make_unique<Factory>(generate_factory(options));
+        state.ResumeTiming();
+        if constexpr (FastForward) {
+            simulate_fast_forward(*factory, turns, [](Factory&, Time) {});
+        } else {
+            simulate(*factory, turns, [](Factory&, Time) {});
+        }
+        state.PauseTiming();
+        factory.reset();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK_TEMPLATE(BM_SimulatePeriodic, false)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_SimulatePeriodic, true)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,132 @@
+#include "benchmark/benchmark.h"
+
+#include "nodes.hpp"
+#include "storage_types.hpp"
+
+#include <cstdint>
+#include <list>
+#include <memory>
+
+// Poprzednia implementacja kolejki: jeden wezel std::list na kazdy polprodukt.
+class ListPackageQueue {
+public:
+    explicit ListPackageQueue(PackageQueueType pqtype) : pqtype_(pqtype) {}
+    void push(Package&& package) { que_.emplace_back(std::move(package)); }
+    bool empty() const { return que_.empty(); }
+    std::list<Package>::const_iterator cbegin() const { return que_.cbegin(); }
+    std::list<Package>::const_iterator cend() const { return que_.cend(); }
+
+    Package pop() {
+        Package output(std::move(pqtype_ == PackageQueueType::FIFO ? que_.front() : que_.back()));
+        if (pqtype_ == PackageQueueType::FIFO) {
+            que_.pop_front();
+        } else {
+            que_.pop_back();
+        }
+        return output;
+    }
+
+private:
+    std::list<Package> que_;
+    PackageQueueType pqtype_;
+};
+
+// Robotnik z `n` polproduktami w kolejce: zapelnienie, przejscie jak w raporcie tury, oproznienie.
+template <class Queue, PackageQueueType type>
+static void BM_QueueFillIterateDrain(benchmark::State& state) {
+    const auto n = static_cast<ElementID>(state.range(0));
+    for (auto _: state) {
+        Queue q(type);
+        for (ElementID id = 1; id <= n; ++id) {
+            q.push(Package(id));
+        }
+        long long checksum = 0;
+        for (auto it = q.cbegin(); it != q.cend(); ++it) {
+            checksum += it->get_id();
+        }
+        benchmark::DoNotOptimize(checksum);
+        while (!q.empty()) {
+            Package p = q.pop();
+            benchmark::DoNotOptimize(p.get_id());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_QueueFillIterateDrain, ListPackageQueue, PackageQueueType::FIFO)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_QueueFillIterateDrain, PackageQueue, PackageQueueType::FIFO)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_QueueFillIterateDrain, ListPackageQueue, PackageQueueType::LIFO)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_QueueFillIterateDrain, PackageQueue, PackageQueueType::LIFO)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+// Samo przejscie po zapelnionej kolejce - tak jak generate_simulation_turn_report w kazdej turze.
+template <class Queue>
+static void BM_QueueIterate(benchmark::State& state) {
+    const auto n = static_cast<ElementID>(state.range(0));
+    Queue q(PackageQueueType::FIFO);
+    for (ElementID id = 1; id <= n; ++id) {
+        q.push(Package(id));
+    }
+    for (auto _: state) {
+        long long checksum = 0;
+        for (auto it = q.cbegin(); it != q.cend(); ++it) {
+            checksum += it->get_id();
+        }
+        benchmark::DoNotOptimize(checksum);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_QueueIterate, ListPackageQueue)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_QueueIterate, PackageQueue)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMicrosecond);
+
+// Pojedyncze push + pop: przez interfejs wirtualny (jak dotad w Worker) i bezposrednio na kolejce statycznej,
+// przy state.range(0) polproduktach lezacych w kolejce (dlugosc kolejki sie nie zmienia).
+template <PackageQueueType Type>
+static void BM_PushPopVirtual(benchmark::State& state) {
+    std::unique_ptr<IPackageQueue> q = std::make_unique<PackageQueue>(Type);
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        q->push(Package());
+    }
+    benchmark::DoNotOptimize(q.get());
+    for (auto _: state) {
+        q->push(Package());
+        Package p = q->pop();
+        benchmark::DoNotOptimize(p.get_id());
+    }
+}
+BENCHMARK_TEMPLATE(BM_PushPopVirtual, PackageQueueType::FIFO)->Arg(0)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_PushPopVirtual, PackageQueueType::LIFO)->Arg(0)->Arg(1024);
+
+template <class Queue>
+static void BM_PushPopStatic(benchmark::State& state) {
+    Queue q;
+    for (std::int64_t i = 0; i < state.range(0); ++i) {
+        q.push(Package());
+    }
+    for (auto _: state) {
+        q.push(Package());
+        Package p = q.pop();
+        benchmark::DoNotOptimize(p.get_id());
+    }
+}
+BENCHMARK_TEMPLATE(BM_PushPopStatic, FifoQueue)->Arg(0)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_PushPopStatic, LifoQueue)->Arg(0)->Arg(1024);
+
+// Kolejka, ktorej Worker nie rozpoznaje jako PackageQueue - obslugiwana przez interfejs wirtualny.
+class OpaquePackageQueue : public PackageQueue {
+public:
+    using PackageQueue::PackageQueue;
+};
+
+// Cykl robotnika: odbior polproduktu, przetworzenie w jednej turze i oddanie z bufora.
+template <class Queue>
+static void BM_WorkerCycle(benchmark::State& state) {
+    Worker worker(1, 1, std::make_unique<Queue>(PackageQueueType::FIFO));
+    Time t = 1;
+    for (auto _: state) {
+        worker.receive_package(Package(1));
+        worker.do_work(t++);
+        Package p = worker.release_sending_buffer();
+        benchmark::DoNotOptimize(p.get_id());
+    }
+}
+BENCHMARK_TEMPLATE(BM_WorkerCycle, OpaquePackageQueue);
+BENCHMARK_TEMPLATE(BM_WorkerCycle, PackageQueue);
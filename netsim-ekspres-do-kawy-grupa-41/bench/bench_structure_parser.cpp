@@ -0,0 +1,46 @@
+#include "benchmark/benchmark.h"
+
+#include "structure_parser.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+// `workers` robotnikow, kazdy z `fan_out` polaczeniami - dla 100k robotnikow to milion linii LINK.
+static std::string make_link_heavy_structure(int workers, int fan_out) {
+    std::ostringstream os;
+    os << "; == LOADING RAMPS ==\n\nLOADING_RAMP id=1 delivery-interval=1\n\n; == WORKERS ==\n\n";
+    for (int id = 1; id <= workers; ++id) {
+        os << "WORKER id=" << id << " processing-time=" << (id % 4 + 1) << " queue-type=" << (id % 2 ? "FIFO" : "LIFO") << "\n";
+    }
+    os << "\n; == STOREHOUSES ==\n\nSTOREHOUSE id=1\n\n; == LINKS ==\n\nLINK src=ramp-1 dest=worker-1\n";
+    for (int id = 1; id <= workers; ++id) {
+        os << "LINK src=worker-" << id << " dest=store-1 p=0.5\n";
+        for (int k = 1; k < fan_out; ++k) {
+            os << "LINK src=worker-" << id << " dest=worker-" << (id + k - 1) % workers + 1 << "\n";
+        }
+    }
+    return os.str();
+}
+
+static void BM_ParseStructureText(benchmark::State& state) {
+    const std::string structure = make_link_heavy_structure(static_cast<int>(state.range(0)), 10);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(parse_factory_structure(structure));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(structure.size()));
+}
+BENCHMARK(BM_ParseStructureText)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_ParseStructureMappedFile(benchmark::State& state) {
+    const std::string structure = make_link_heavy_structure(static_cast<int>(state.range(0)), 10);
+    const std::string path = "/tmp/net_simulation_bench_structure.txt";
+    std::ofstream(path, std::ios::binary) << structure;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(load_factory_structure_file(path));
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(structure.size()));
+}
+BENCHMARK(BM_ParseStructureMappedFile)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,64 @@
+#include "benchmark/benchmark.h"
+
+#include "factory.hpp"
+#include "worker_store.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// `workers` robotnikow o czasach przetwarzania 1..8; dwie trzecie zajete polproduktem rozpoczetym w turach 1..10
+static Factory make_busy_factory(ElementID workers) {
+    Factory factory;
+    std::uint64_t lcg = 2021;
+    auto next = [&lcg](int bound) {
+        lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>((lcg >> 33) % static_cast<std::uint64_t>(bound));
+    };
+    for (ElementID id = 1; id <= workers; ++id) {
+        Worker worker(id, next(8) + 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+        if (next(3) != 0) {
+            worker.receive_package(Package(factory.get_context()));
+            worker.do_work(next(10) + 1);
+        }
+        factory.add_worker(std::move(worker));
+    }
+    return factory;
+}
+
+// Dotychczasowy test w petli po NodeCollection<Worker> (lista, obiekty z dwiema tablicami wirtualnymi)
+static void BM_FinishedTestAoS(benchmark::State& state) {
+    Factory factory = make_busy_factory(static_cast<ElementID>(state.range(0)));
+    std::vector<std::uint8_t> finished(static_cast<std::size_t>(state.range(0)));
+    Time t = 8;
+    for (auto _: state) {
+        std::size_t i = 0;
+        for (auto it = factory.worker_cbegin(); it != factory.worker_cend(); ++it, ++i) {
+            finished[i] = it->get_processing_buffer().has_value()
+                    and t - it->get_package_processing_start_time() >= it->get_processing_duration() - 1;
+        }
+        benchmark::DoNotOptimize(finished.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FinishedTestAoS)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+
+static void BM_FinishedTestSoA(benchmark::State& state) {
+    Factory factory = make_busy_factory(static_cast<ElementID>(state.range(0)));
+    WorkerStore store;
+    store.resize(static_cast<std::size_t>(state.range(0)));
+    std::size_t i = 0;
+    for (auto it = factory.worker_cbegin(); it != factory.worker_cend(); ++it) {
+        store.load(i++, *it);
+    }
+    std::vector<std::uint8_t> finished(store.size());
+    Time t = 8;
+    for (auto _: state) {
+        store.mark_finished(t, finished.data());
+        benchmark::DoNotOptimize(finished.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FinishedTestSoA)->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
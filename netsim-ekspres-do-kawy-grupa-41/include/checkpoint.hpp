@@ -0,0 +1,30 @@
+#ifndef NET_SIMULATION_CHECKPOINT_HPP
+#define NET_SIMULATION_CHECKPOINT_HPP
+
+#include "factory.hpp"
+#include "types.hpp"
+
+#include <istream>
+#include <ostream>
+
+// Binarny punkt kontrolny symulacji: struktura sieci z wagami polaczen, zawartosc wszystkich buforow,
+// kolejek i magazynow (z czasem narodzin i rampa polproduktow, latency.hpp), stan puli ID, stan generatorow
+// (strumieni wezlow i generatora globalnego) oraz tura. Metryki i histogramy opoznien nie sa zapisywane -
+// po wznowieniu obejmuja tylko polprodukty przyjete od wznowienia. Magazyny z retention.hpp zachowuja polityke
+// i liczbe przyjetych polproduktow; ID z pliku SPILL trafiaja przy odczycie do nowego pliku tymczasowego, a plik
+// pod zapisana sciezka pozostaje nietkniety (moze go wciaz uzywac magazyn zrodlowy).
+// Liczby zapisywane sa w natywnym porzadku bajtow - plik przenosi sie tylko miedzy maszynami o tej samej architekturze.
+struct Checkpoint {
+    Factory factory;
+    Time turn;
+};
+
+// Zapisuje stan po zakonczeniu tury `turn`. Rzuca std::logic_error, jesli ktorys wezel uzywa generatora,
+// ktorego stanu nie da sie zapisac (tzn. innego niz RandomStream lub default_probability_generator).
+void save_checkpoint(const Factory& factory, Time turn, std::ostream& os);
+
+// Odtwarza fabryke i ustawia globalny generator `rng`; symulacje wznawia simulate_from(factory, turn + 1, ...).
+// Rzuca std::runtime_error dla uszkodzonego lub niezgodnego pliku.
+Checkpoint load_checkpoint(std::istream& is);
+
+#endif //NET_SIMULATION_CHECKPOINT_HPP
@@ -0,0 +1,62 @@
+#ifndef NET_SIMULATION_COMPILED_FACTORY_HPP
+#define NET_SIMULATION_COMPILED_FACTORY_HPP
+
+#include "factory.hpp"
+#include "worker_store.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Zamrozony uklad spojnej fabryki dla petli symulacji: wezly w gestych tablicach, polaczenia w postaci CSR
+// (przesuniecia nadawcow + odbiorcy z tablica aliasow). Przekazywanie polproduktow nie przeglada map
+// preferencji i nie wywoluje metod wirtualnych odbiorcow. Stan (polprodukty, bufory) pozostaje w wezlach
+// fabryki, wiec raporty generuje sie dla niej jak zwykle, a wyniki sa identyczne z Factory::do_*.
+class CompiledFactory {
+public:
+    // Rzuca std::logic_error, gdy siec nie jest spojna.
+    explicit CompiledFactory(Factory& factory);
+
+    void do_deliveries(Time t);
+    void do_package_passing();
+    void do_work(Time t);
+
+    // Ponownie odczytuje stan robotnikow - potrzebne, gdy fabryke symulowano z pominieciem tego ukladu.
+    void sync_workers();
+
+    // Fabryka zmienila wezly, polaczenia lub wagi polaczen po kompilacji - uklad trzeba zbudowac od nowa.
+    bool is_stale() const;
+
+    Factory& get_factory() const { return *factory_; }
+    std::size_t ramp_count() const { return ramps_.size(); }
+    std::size_t worker_count() const { return workers_.size(); }
+    std::size_t storehouse_count() const { return storehouses_.size(); }
+    // Indeksy sa zgodne z kolejnoscia kolekcji fabryki
+    ElementID get_ramp_id(std::size_t index) const { return ramps_[index]->get_id(); }
+    ElementID get_worker_id(std::size_t index) const { return workers_[index]->get_id(); }
+    ElementID get_storehouse_id(std::size_t index) const { return storehouses_[index]->get_id(); }
+    const WorkerStore& get_worker_store() const { return worker_store_; }
+
+private:
+    void pass_from(PackageSender& sender, std::size_t sender_index);
+
+    Factory* factory_;
+    std::uint64_t topology_version_;
+    std::uint64_t link_version_;
+//    ReceiverTable::get_rebuild_count() kazdego nadawcy w chwili kompilacji (indeksy jak w edge_offsets_)
+    std::vector<std::uint64_t> table_versions_;
+
+    std::vector<Ramp*> ramps_;
+    std::vector<Worker*> workers_;
+    std::vector<Storehouse*> storehouses_;
+
+//    Nadawcy: rampy [0, R), robotnicy [R, R + W). Odbiorcy: robotnicy [0, W), magazyny [W, W + S).
+    std::vector<std::uint32_t> edge_offsets_;
+    std::vector<std::uint32_t> edge_targets_;
+    std::vector<double> alias_probability_;
+    std::vector<std::uint32_t> alias_;
+
+    WorkerStore worker_store_;
+    std::vector<std::uint8_t> finished_;
+};
+
+#endif //NET_SIMULATION_COMPILED_FACTORY_HPP
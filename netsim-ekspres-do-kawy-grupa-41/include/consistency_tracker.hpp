@@ -0,0 +1,106 @@
+#ifndef NET_SIMULATION_CONSISTENCY_TRACKER_HPP
+#define NET_SIMULATION_CONSISTENCY_TRACKER_HPP
+
+#include "nodes.hpp"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+
+enum class TrackedKind : std::uint8_t {
+    RAMP,
+    WORKER,
+    STOREHOUSE
+};
+
+// Dla kazdego wezla pamieta, czy dochodzi do magazynu i czy jest zasilany z rampy; licznik wezlow zasilanych,
+// ktore do magazynu nie dochodza, daje werdykt w czasie stalym. Dodanie polaczenia lub wezla rozchodzi sie tylko
+// po wezlach, ktore zmieniaja stan; usuniecie przelicza jedynie poprzednikow (nastepnikow) miejsca zmiany.
+class ConsistencyTracker : public LinkObserver {
+public:
+    ConsistencyTracker() = default;
+    ConsistencyTracker(const ConsistencyTracker&) = delete;
+    ConsistencyTracker& operator=(const ConsistencyTracker&) = delete;
+
+    // `receiver` to adres wezla w fabryce (dla rampy nullptr) - polaczenie liczy sie jako wewnetrzne tylko wtedy,
+    // gdy prowadzi dokladnie do niego.
+    void add_node(TrackedKind kind, ElementID id, const IPackageReceiver* receiver);
+    // Usuwa tez polaczenia wychodzace wezla; przychodzace musi wczesniej usunac wlasciciel nadawcow.
+    void remove_node(TrackedKind kind, ElementID id);
+    // Zapomina wszystkie wezly i polaczenia (licznik zmian polaczen zostaje) - przed ponownym zgloszeniem calej fabryki.
+    void clear();
+
+    void link_added(SenderType sender_type, ElementID sender_id, ReceiverTable::ReceiverKey key, const IPackageReceiver* receiver) override;
+    void link_removed(SenderType sender_type, ElementID sender_id, ReceiverTable::ReceiverKey key, const IPackageReceiver* receiver) override;
+
+    // Werdykt jest dokladny, gdy kazde polaczenie prowadzi do sledzonego wezla i zadne ID sie nie powtarza.
+    bool is_exact() const { return outside_links_ == 0 and duplicated_ids_ == 0; }
+    // Po usunieciu ostatniego powtorzenia stan grafu jest nieaktualny - wlasciciel musi zglosic fabryke od nowa.
+    bool has_duplicated_ids() const { return duplicated_ids_ > 0; }
+    bool is_consistent() const { return offending_nodes_ == 0; }
+    // Liczba zgloszonych zmian polaczen - pozwala stwierdzic, ze uklad zbudowany z fabryki jest nieaktualny
+    std::uint64_t get_link_changes() const { return link_changes_; }
+
+    // Nadawcy wysylajacy do danego wezla - przy usuwaniu wezla wystarczy odwiedzic tylko ich.
+    std::vector<std::pair<TrackedKind, ElementID>> get_predecessors(TrackedKind kind, ElementID id) const;
+
+private:
+    struct Node {
+        std::vector<Node*> successors;
+        std::vector<Node*> predecessors;
+        const IPackageReceiver* receiver = nullptr;
+        TrackedKind kind;
+        ElementID id;
+        // Polaczenia wychodzace do odbiorcow spoza fabryki - nie naleza do grafu
+        std::size_t outside_links = 0;
+        // Dodatkowe wezly o tym samym ID
+        std::size_t copies = 0;
+        bool present = false;
+        bool reaches_storehouse = false;
+        bool fed_by_ramp = false;
+        std::uint32_t mark = 0;
+    };
+
+    static std::uint64_t key(TrackedKind kind, ElementID id) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(id)) << 2) | static_cast<std::uint64_t>(kind);
+    }
+    static bool is_offending(const Node& node) {
+        return node.present and node.kind != TrackedKind::STOREHOUSE and node.fed_by_ramp and !node.reaches_storehouse;
+    }
+    static bool is_reach_source(const Node& node) { return node.present and node.kind == TrackedKind::STOREHOUSE; }
+    static bool is_feed_source(const Node& node) { return node.present and node.kind == TrackedKind::RAMP; }
+    static bool sends_to_storehouse(const Node& node);
+    static bool receives_from_ramp(const Node& node);
+
+    Node& node(TrackedKind kind, ElementID id);
+    Node* find_node(TrackedKind kind, ElementID id);
+    Node* find_receiver(ReceiverTable::ReceiverKey key, const IPackageReceiver* receiver);
+    void erase_if_unused(Node& node);
+    void remove_link(Node& sender, Node& receiver);
+
+    template <class Mutation>
+    void update(Node& node, Mutation mutation) {
+        offending_nodes_ -= is_offending(node);
+        mutation(node);
+        offending_nodes_ += is_offending(node);
+    }
+
+    void spread_reach(Node& start);
+    void spread_feed(Node& start);
+    void recompute_reach(Node& start);
+    void recompute_feed(Node& start);
+
+    std::unordered_map<std::uint64_t, Node> nodes_;
+    std::size_t offending_nodes_ = 0;
+    std::size_t outside_links_ = 0;
+    std::uint64_t link_changes_ = 0;
+    std::size_t duplicated_ids_ = 0;
+
+    std::uint32_t epoch_ = 0;
+    std::vector<Node*> stack_;
+    std::vector<Node*> affected_;
+};
+
+
+#endif //NET_SIMULATION_CONSISTENCY_TRACKER_HPP
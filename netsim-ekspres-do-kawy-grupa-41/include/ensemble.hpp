@@ -0,0 +1,38 @@
+#ifndef NET_SIMULATION_ENSEMBLE_HPP
+#define NET_SIMULATION_ENSEMBLE_HPP
+
+#include "factory.hpp"
+#include "thread_pool.hpp"
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Zagregowane wyniki wszystkich replik dla jednego wezla.
+// Wartoscia jest liczba polproduktow w wezle po zakonczeniu symulacji:
+// dla magazynu - liczba przyjetych polproduktow, dla robotnika - kolejka razem z buforami.
+struct NodeStatistics {
+    ElementType type;
+    ElementID id;
+    double mean;
+    double variance;    // wariancja z proby (n - 1)
+    double ci_low;      // przedzial ufnosci sredniej: mean -/+ z * sqrt(variance / n)
+    double ci_high;
+};
+
+struct EnsembleOptions {
+    TimeOffset turns = 100;
+    std::size_t replicas = 100;
+    std::uint64_t base_seed = 0;
+    double confidence_z = 1.96;
+};
+
+// Uruchamia `replicas` niezaleznych symulacji sieci opisanej w `structure` (format load_factory_structure()).
+// Kazda replika ma wlasne strumienie losowe wezlow (ziarno wyznaczane z base_seed i numeru repliki) i wlasna pule ID,
+// wiec wynik nie zalezy od liczby watkow w `pool`.
+// Wezly zwracane sa w kolejnosci: robotnicy, magazyny - kazda grupa rosnaco po ID.
+std::vector<NodeStatistics> run_ensemble(const std::string& structure, const EnsembleOptions& options, ThreadPool& pool);
+
+#endif //NET_SIMULATION_ENSEMBLE_HPP
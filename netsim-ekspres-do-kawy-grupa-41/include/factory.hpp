@@ -6,8 +6,14 @@
 #define NET_SIMULATION_FACTORY_HPP
 
 #include "nodes.hpp"
+#include "consistency_tracker.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <cstdint>
 #include <list>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 #include <algorithm>
 #include <string>
 #include <sstream>
@@ -15,11 +21,6 @@
 #include <iostream>
 
 
-enum class NodeColor {
-    UNVISITED,
-    VISITED,
-    VERIFIED };
-
 enum class ElementType{
     LOADING_RAMP ,
     WORKER,
@@ -32,7 +33,13 @@ enum class NodeType{
     SENDER
 };
 
-bool has_reachable_storehouse(const PackageSender* sender, std::map<const PackageSender*, NodeColor>& node_colors);
+// Wynik sprawdzenia spojnosci: siec jest spojna, gdy z kazdego nadawcy osiagalnego z rampy da sie dojsc do magazynu.
+// Nadawcy, z ktorych magazyn jest nieosiagalny (w tym bez odbiorcow), to winowajcy - rosnaco po ID.
+struct ConsistencyReport {
+    bool consistent = true;
+    std::vector<ElementID> offending_ramps;
+    std::vector<ElementID> offending_workers;
+};
 
 template <class Node>
 class NodeCollection{
@@ -41,19 +48,44 @@ public:
     using iterator = typename container_t::iterator;
     using const_iterator = typename container_t::const_iterator;
 
+    NodeCollection() = default;
+    NodeCollection(const NodeCollection&) = delete;
+    NodeCollection(NodeCollection&&) = default;
+    NodeCollection& operator=(const NodeCollection&) = delete;
+    NodeCollection& operator=(NodeCollection&&) = default;
+
     iterator find_by_id(ElementID id) {
-        return std::find_if(collection_.begin(), collection_.end(), [=](const Node& node){ return node.get_id() == id; });
+        auto found = index_.find(id);
+        return found == index_.end() ? collection_.end() : found->second;
     }
 
     const_iterator find_by_id(ElementID id) const {
-        return std::find_if(collection_.begin(), collection_.end(), [=](const Node& node){ return node.get_id() == id; } );
+        auto found = index_.find(id);
+        return found == index_.end() ? collection_.cend() : const_iterator(found->second);
+    }
+
+    Node& add(Node&& node) {
+        collection_.emplace_back(std::move(node));
+        if (!index_.emplace(collection_.back().get_id(), std::prev(collection_.end())).second) {
+            duplicated_ids_++;
+        }
+        return collection_.back();
     }
 
-    void add(Node&& node) { collection_.emplace_back(std::move(node)); }
     void remove_by_id(ElementID id) {
-        const_iterator iter = find_by_id(id);
-        if (iter != collection_.cend() ){
-            collection_.erase(iter);
+        auto found = index_.find(id);
+        if (found == index_.end()) {
+            return;
+        }
+        collection_.erase(found->second);
+        index_.erase(found);
+//        Przy powtorzonych ID indeks musi wskazywac kolejny (pierwszy na liscie) wezel o tym ID
+        if (duplicated_ids_ > 0) {
+            auto duplicate = std::find_if(collection_.begin(), collection_.end(), [=](const Node& node){ return node.get_id() == id; });
+            if (duplicate != collection_.end()) {
+                index_.emplace(id, duplicate);
+                duplicated_ids_--;
+            }
         }
     }
 
@@ -63,62 +95,108 @@ public:
     const_iterator end() const { return collection_.cend(); }
     const_iterator cbegin() const  { return collection_.cbegin(); }
     const_iterator cend() const  { return collection_.cend(); }
+    std::size_t size() const { return collection_.size(); }
 
 private:
+    // std::list gwarantuje stabilnosc adresow wezlow (ReceiverPreferences trzyma surowe wskazniki),
+    // a indeks ID -> iterator daje wyszukiwanie w czasie stalym
     container_t collection_;
+    std::unordered_map<ElementID, iterator> index_;
+    std::size_t duplicated_ids_ = 0;
 };
 
 class Factory {
 public:
-    void add_ramp(Ramp&& ramp) { ramps_.add(std::move(ramp)); }
-    void remove_ramp(ElementID id) { ramps_.remove_by_id(id); }
+    Factory() = default;
+    // Fabryka po przeniesieniu jest pusta, z nowym kontekstem i sledzeniem spojnosci - mozna jej dalej uzywac
+    Factory(Factory&& other);
+    Factory& operator=(Factory&& other);
+
+    void add_ramp(Ramp&& ramp);
+    void remove_ramp(ElementID id);
     NodeCollection<Ramp>::iterator find_ramp_by_id(ElementID id) { return ramps_.find_by_id(id); }
     NodeCollection<Ramp>::const_iterator find_ramp_by_id(ElementID id) const { return ramps_.find_by_id(id); }
+    NodeCollection<Ramp>::iterator ramp_begin() { return ramps_.begin(); }
+    NodeCollection<Ramp>::iterator ramp_end() { return ramps_.end(); }
     NodeCollection<Ramp>::const_iterator ramp_cbegin() const { return ramps_.cbegin(); }
     NodeCollection<Ramp>::const_iterator ramp_cend() const { return ramps_.cend(); }
 
-    void add_worker(Worker&& worker) { workers_.add(std::move(worker)); }
+    void add_worker(Worker&& worker);
     void remove_worker(ElementID id);
     NodeCollection<Worker>::iterator find_worker_by_id(ElementID id) { return workers_.find_by_id(id); }
     NodeCollection<Worker>::const_iterator find_worker_by_id(ElementID id) const { return workers_.find_by_id(id); }
+    NodeCollection<Worker>::iterator worker_begin() { return workers_.begin(); }
+    NodeCollection<Worker>::iterator worker_end() { return workers_.end(); }
     NodeCollection<Worker>::const_iterator worker_cbegin() const { return workers_.cbegin(); }
     NodeCollection<Worker>::const_iterator worker_cend() const { return workers_.cend(); }
 
-    void add_storehouse(Storehouse&& storehouse) { storehouses_.add(std::move(storehouse)); }
+    void add_storehouse(Storehouse&& storehouse);
     void remove_storehouse(ElementID id);
     NodeCollection<Storehouse>::iterator find_storehouse_by_id(ElementID id) { return storehouses_.find_by_id(id); }
     NodeCollection<Storehouse>::const_iterator find_storehouse_by_id(ElementID id) const { return storehouses_.find_by_id(id); }
+    NodeCollection<Storehouse>::iterator storehouse_begin() { return storehouses_.begin(); }
+    NodeCollection<Storehouse>::iterator storehouse_end() { return storehouses_.end(); }
     NodeCollection<Storehouse>::const_iterator storehouse_cbegin() const { return storehouses_.cbegin(); }
     NodeCollection<Storehouse>::const_iterator storehouse_cend() const { return storehouses_.cend(); }
 
+    // Kontekst jest wlasnoscia fabryki i ma staly adres (takze po przeniesieniu fabryki).
+    SimulationContext& get_context() { return *context_; }
+    const SimulationContext& get_context() const { return *context_; }
+
+    // Daje kazdemu nadawcy wlasny strumien RandomStream(seed, numer nadawcy) - losowania wezla
+    // nie zaleza wtedy od kolejnosci losowan innych wezlow ani od watku, na ktorym dzialaja.
+    void seed_streams(std::uint64_t seed);
+
+    // Zmienia sie przy kazdym dodaniu/usunieciu wezla; wartosci sa unikalne dla calego procesu,
+    // wiec pamiec podreczna oparta na wersji nie pomyli dwoch roznych fabryk.
+    std::uint64_t get_topology_version() const { return topology_version_; }
+    // Zmienia sie przy kazdym dodaniu/usunieciu polaczenia (zmiana samej wagi sie nie liczy).
+    std::uint64_t get_link_version() const { return tracker_->get_link_changes(); }
+
+    // Werdykt jest utrzymywany przyrostowo przy kazdej zmianie wezlow i polaczen, wiec zwykle nic nie jest przeliczane.
+    // Pelne sprawdzenie nastepuje tylko, gdy polaczenia prowadza poza fabryke albo ID sie powtarzaja;
+    // polaczenie do odbiorcy spoza fabryki oznacza siec niespojna.
     bool is_consistent() const;
+    // Czy is_consistent() odpowiada ze sledzenia przyrostowego, bez pelnego sprawdzenia
+    bool has_exact_tracking() const { return tracker_->is_exact(); }
+    // Rzuca std::logic_error, gdy ktorys nadawca wysyla do odbiorcy spoza fabryki (takze do obcego obiektu o ID jej wezla)
+    ConsistencyReport check_consistency() const;
     void do_deliveries (Time t);
     void do_package_passing();
     void do_work(Time t);
 
-private:
-    template<class Node>
-    void remove_receiver(NodeCollection<Node>& collection , ElementID id) {
-        for(auto& node: collection){
-            auto pref_t_ptr = std::find_if(node.receiver_preferences_.begin(), node.receiver_preferences_.end(), [=](auto& pair) { return pair.first->get_id() == id; });
-            auto receiver_ptr = pref_t_ptr->first;
-            node.receiver_preferences_.remove_receiver(receiver_ptr);
-        }
-    }
+    // Wersje rownolegle - wynik jest identyczny z sekwencyjnym niezaleznie od liczby watkow:
+    // ID polproduktow i losowania odbiorcow nastepuja w kolejnosci kolekcji, rownolegle wykonywana jest reszta.
+    void do_deliveries(Time t, ThreadPool& pool);
+    void do_package_passing(ThreadPool& pool);
+    void do_work(Time t, ThreadPool& pool);
 
+private:
+    // Usuwa polaczenia do odbiorcy: wystarczy odwiedzic nadawcow znanych sledzeniu spojnosci,
+    // a przy powtorzonych ID (gdy sledzenie ich nie rozroznia) - wszystkich.
+    void remove_links_to(IPackageReceiver* receiver, TrackedKind kind);
+    // Po usunieciu wezla z kolekcji; gdy zniknelo ostatnie powtorzone ID, zglasza sledzeniu cala fabryke od nowa
+    void untrack_node(TrackedKind kind, ElementID id);
+
+    void update_views();
+    void topology_changed() { views_valid_ = false; topology_version_ = ++topology_counter_; }
+
+    // Musi zostac zniszczony po wezlach - polprodukty zwracaja do niego swoje ID
+    std::unique_ptr<SimulationContext> context_ = std::make_unique<SimulationContext>();
+    // Staly adres - nadawcy trzymaja do niego wskaznik jako obserwatora polaczen
+    std::unique_ptr<ConsistencyTracker> tracker_ = std::make_unique<ConsistencyTracker>();
     NodeCollection<Ramp> ramps_;
     NodeCollection<Worker> workers_;
     NodeCollection<Storehouse> storehouses_;
-};
-
-struct ParsedLineData{
-    using parameters_t = std::map<std::string, std::string>;
-    ElementType element_type;
-    parameters_t parameters;
-};
 
-ParsedLineData parse_line(std::string line);
+    // Wezly w kolejnosci kolekcji z dostepem swobodnym - do dzielenia pracy miedzy watki
+    std::vector<Ramp*> ramp_views_;
+    std::vector<Worker*> worker_views_;
+    bool views_valid_ = false;
 
+    std::uint64_t topology_version_ = 0;
+    inline static std::atomic<std::uint64_t> topology_counter_{0};
+};
 
 Factory load_factory_structure(std::istream& is);
 
@@ -0,0 +1,40 @@
+#ifndef NET_SIMULATION_FACTORY_GENERATOR_HPP
+#define NET_SIMULATION_FACTORY_GENERATOR_HPP
+
+#include "factory.hpp"
+#include "types.hpp"
+
+#include <cstdint>
+#include <ostream>
+
+// Przedzial [min, max], z ktorego wartosci losowane sa z rozkladem jednostajnym
+struct UniformRange {
+    int min;
+    int max;
+};
+
+struct FactoryGeneratorOptions {
+    ElementID ramps = 10;
+    ElementID workers = 1000;
+    ElementID storehouses = 10;
+    // Robotnicy dzieleni sa na tyle warstw (najwyzej tyle, ilu jest robotnikow)
+    int layers = 10;
+    // Liczba odbiorcow kazdej rampy i kazdego robotnika - moze byc wieksza, gdy nastepna warstwa jest liczniejsza
+    // od nadawcow, bo kazdy jej wezel musi dostac nadawce
+    UniformRange fan_out{1, 3};
+    // Prawdopodobienstwo kolejki LIFO u robotnika (wpp. FIFO)
+    double lifo_fraction = 0.5;
+    UniformRange processing_time{1, 3};
+    UniformRange delivery_interval{1, 5};
+    std::uint64_t seed = 0;
+};
+
+// Losowa warstwowa siec: rampy -> warstwa 1 -> ... -> warstwa `layers` -> magazyny. Kazdy robotnik ma
+// nadawce z poprzedniej warstwy (lub rampe) i odbiorcow tylko w nastepnej (lub magazyny), wiec siec jest
+// spojna z konstrukcji. Te same opcje daja zawsze te sama siec, w obu postaciach ponizej.
+// Rzuca std::invalid_argument dla niepoprawnych opcji.
+void generate_factory_structure(const FactoryGeneratorOptions& options, std::ostream& os);
+
+Factory generate_factory(const FactoryGeneratorOptions& options);
+
+#endif //NET_SIMULATION_FACTORY_GENERATOR_HPP
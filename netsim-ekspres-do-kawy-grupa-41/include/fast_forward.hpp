@@ -0,0 +1,76 @@
+#ifndef NET_SIMULATION_FAST_FORWARD_HPP
+#define NET_SIMULATION_FAST_FORWARD_HPP
+
+#include "factory.hpp"
+#include "types.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Tury pominiete przez przeskok nad okresami (simulate_fast_forward w simulation.hpp)
+struct FastForwardSpan {
+    Time first_turn;
+    Time last_turn;
+    TimeOffset period;
+    Time periods;
+    // Polprodukty dostarczone przez rampy w pominietych turach
+    std::uint64_t packages_delivered;
+    // Polprodukty przyjete w pominietych turach przez kazdy magazyn (w kolejnosci kolekcji fabryki)
+    std::vector<std::pair<ElementID, std::uint64_t>> storehouse_packages;
+};
+
+// Wykrywanie okresowego stanu ustalonego. Po kazdej turze liczony jest skrot stanu fabryki z pominieciem ID
+// polproduktow (fazy dostaw ramp, dlugosci kolejek, zajetosc i postep pracy robotnikow, zajetosc buforow).
+// Powtorzony skrot daje kandydata na okres, potwierdzany przez pelne porownanie stanu po dwoch kolejnych okresach:
+// kazda pozycja (miejsce w kolejce, bufor) musi w obu okresach dostac ID wieksze o tyle samo - 0 (polprodukt stoi)
+// albo o liczbe nowych ID z okresu - a magazyny musza przyjac te same polprodukty przesuniete o te liczbe.
+// Wtedy kolejne okresy wygladaja tak samo i mozna je przeskoczyc, wyliczajac tylko ID i zawartosc magazynow.
+//
+// Przeskok jest mozliwy tylko dla sieci deterministycznych: kazdy nadawca ma jednego odbiorce (losowanie
+// zuzywa liczby, ale nie zmienia wyniku; strumienie RandomStream sa przesuwane o pominiete losowania,
+// inne generatory nie), kolejki robotnikow to PackageQueue, pula ID nie ma zwolnionych ID, magazyny
+// pokazuja caly swoj stan przez iteratory (polityki z retention.hpp blokuja przeskok, gdy zaczna cos pomijac
+// lub przenosic do pliku),
+// a metryki wezlow i pomiar opoznien nie sa wkompilowane.
+class PeriodicFastForward {
+public:
+    // `max_period` - najdluzszy wykrywany okres (i liczba pamietanych skrotow)
+    explicit PeriodicFastForward(Factory& factory, TimeOffset max_period = 4096);
+
+    bool is_applicable() const { return applicable_; }
+
+    // Wywolywana po kazdej turze `t`. Zwraca dlugosc okresu, gdy stan po turze t jest potwierdzony jako
+    // okresowy (wtedy mozna wywolac skip()), wpp. 0.
+    TimeOffset observe(Time t);
+
+    // Przenosi fabryke ze stanu po turze `t` (ostatniej przekazanej do observe()) o `periods` okresow naprzod.
+    FastForwardSpan skip(Time t, Time periods);
+
+private:
+    struct Snapshot {
+        Time turn = 0;
+        std::vector<std::int64_t> shape;
+        std::vector<ElementID> ids;
+        ElementID next_fresh_id = 0;
+        std::vector<std::size_t> storehouse_sizes;
+        // Czy przez iteratory magazynow widac wszystkie przyjete polprodukty (patrz retention.hpp)
+        bool complete_stock = true;
+        std::vector<std::uint64_t> stream_positions;
+    };
+
+    std::uint64_t shape_hash(Time t) const;
+    Snapshot capture(Time t) const;
+    bool repeats(const Snapshot& a, const Snapshot& b, const Snapshot& c) const;
+    void reset();
+
+    Factory* factory_;
+    bool applicable_;
+    TimeOffset max_period_;
+    std::unordered_map<std::uint64_t, Time> seen_;
+    TimeOffset period_ = 0;
+    std::vector<Snapshot> snapshots_;
+};
+
+#endif //NET_SIMULATION_FAST_FORWARD_HPP
@@ -5,16 +5,22 @@
 #ifndef NET_SIMULATION_HELPERS_HPP
 #define NET_SIMULATION_HELPERS_HPP
 
+#include <cstdint>
 #include <functional>
 #include <random>
 
 #include "types.hpp"
+#include "random.hpp"
 
-extern std::random_device rd;
-extern std::mt19937 rng;
+// Generator i domyslne zrodlo prawdopodobienstwa sa osobne dla kazdego watku,
+// dzieki czemu niezalezne symulacje (np. repliki w run_ensemble()) moga dzialac rownolegle.
+// Bez wywolania seed_rng() ziarno pochodzi z std::random_device.
+extern thread_local RandomStream rng;
+
+extern void seed_rng(std::uint64_t seed);
 
 extern double default_probability_generator();
 
-extern ProbabilityGenerator probability_generator;
+extern thread_local ProbabilityGenerator probability_generator;
 
 #endif //NET_SIMULATION_HELPERS_HPP
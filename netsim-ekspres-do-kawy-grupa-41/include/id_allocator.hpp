@@ -0,0 +1,35 @@
+#ifndef NET_SIMULATION_ID_ALLOCATOR_HPP
+#define NET_SIMULATION_ID_ALLOCATOR_HPP
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Przydzial ID polproduktow: najpierw najmniejsze zwolnione ID, a gdy takiego nie ma - kolejne nowe.
+// Zwolnione ID trzymane sa w hierarchicznej bitmapie (drzewo o stopniu 64), wiec zarowno allocate()
+// jak i release() wykonuja co najwyzej log_64(n) krokow - dla zakresu ElementID to najwyzej 6 slow.
+class IdAllocator {
+public:
+    ElementID allocate();
+    void release(ElementID id);
+
+    bool has_freed_ids() const { return !levels_.empty() && levels_.back().front() != 0; }
+    ElementID get_next_fresh_id() const { return next_fresh_id_; }
+
+    // Pelny stan puli (np. do punktu kontrolnego): zwolnione ID rosnaco oraz kolejne nowe ID.
+    std::vector<ElementID> get_freed_ids() const;
+    void restore(ElementID next_fresh_id, const std::vector<ElementID>& freed_ids);
+
+private:
+    using word_t = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    void reserve(std::size_t bits);
+
+    // levels_[0] - bit na kazde ID, levels_[k + 1] - bit na kazde niezerowe slowo z levels_[k]
+    std::vector<std::vector<word_t>> levels_;
+    ElementID next_fresh_id_ = 1;
+};
+
+#endif //NET_SIMULATION_ID_ALLOCATOR_HPP
@@ -0,0 +1,87 @@
+#ifndef NET_SIMULATION_LATENCY_HPP
+#define NET_SIMULATION_LATENCY_HPP
+
+#include "types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+// Opoznienie polproduktow od dostawy na rampie do przyjecia w magazynie, wlaczane w czasie kompilacji
+// (-DWITH_PACKAGE_LATENCY, w CMake opcja NET_SIMULATION_LATENCY). Bez flagi polprodukt nie nosi czasu
+// narodzin, a rejestratory magazynow sa puste.
+#if defined(WITH_PACKAGE_LATENCY)
+inline constexpr bool package_latency_enabled = true;
+#else
+inline constexpr bool package_latency_enabled = false;
+#endif
+
+// Histogram w stylu HDR: przedzialy rosnace wykladniczo, kazda potega dwojki podzielona na sub_bucket_count
+// rownych czesci. Wartosci ponizej 2 * sub_bucket_count sa dokladne, wieksze - z bledem wzglednym
+// najwyzej 1 / sub_bucket_count. Pamiec stala, zapis O(1).
+class LatencyHistogram {
+public:
+    static constexpr unsigned sub_bucket_bits = 5;
+    static constexpr std::size_t sub_bucket_count = std::size_t{1} << sub_bucket_bits;
+    static constexpr std::size_t bucket_count = (32 - sub_bucket_bits + 1) * sub_bucket_count;
+
+    void record(std::uint32_t value) {
+        ++counts_[bucket_index(value)];
+        ++count_;
+        sum_ += value;
+        if (count_ == 1 or value < min_) {
+            min_ = value;
+        }
+        if (value > max_) {
+            max_ = value;
+        }
+    }
+    void merge(const LatencyHistogram& other);
+
+    std::uint64_t count() const { return count_; }
+    std::uint32_t min() const { return min_; }
+    std::uint32_t max() const { return max_; }
+    double mean() const { return count_ > 0 ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+    // Najmniejsza wartosc v (z dokladnoscia do przedzialu), dla ktorej co najmniej q * count() pomiarow jest <= v;
+    // 0 dla pustego histogramu.
+    std::uint32_t percentile(double q) const;
+
+    static std::size_t bucket_index(std::uint32_t value);
+    // Najwieksza wartosc trafiajaca do przedzialu `index`
+    static std::uint32_t bucket_upper_bound(std::size_t index);
+
+private:
+    std::array<std::uint64_t, bucket_count> counts_{};
+    std::uint64_t count_ = 0;
+    std::uint64_t sum_ = 0;
+    std::uint32_t min_ = 0;
+    std::uint32_t max_ = 0;
+};
+
+// Opoznienia polproduktow przyjetych przez jeden magazyn: lacznie oraz osobno dla kazdej sciezki,
+// czyli rampy, z ktorej polprodukt wyszedl.
+class LatencyRecorder {
+public:
+    using path_histograms_t = std::unordered_map<ElementID, LatencyHistogram>;
+
+#if defined(WITH_PACKAGE_LATENCY)
+    void record(ElementID origin, Time latency) {
+        const auto value = static_cast<std::uint32_t>(latency);
+        total_.record(value);
+        paths_[origin].record(value);
+    }
+    const LatencyHistogram& get_total() const { return total_; }
+    const path_histograms_t& get_paths() const { return paths_; }
+
+private:
+    LatencyHistogram total_;
+    path_histograms_t paths_;
+#else
+    void record(ElementID, Time) {}
+    const LatencyHistogram& get_total() const;
+    const path_histograms_t& get_paths() const;
+#endif
+};
+
+#endif //NET_SIMULATION_LATENCY_HPP
@@ -0,0 +1,60 @@
+#ifndef NET_SIMULATION_METRICS_HPP
+#define NET_SIMULATION_METRICS_HPP
+
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// Metryki wezlow wlaczane w czasie kompilacji (-DWITH_NODE_METRICS, w CMake opcja NET_SIMULATION_METRICS).
+// Bez flagi liczniki sa pustymi klasami o pustych metodach, a miejsca wywolan sa wyciete przez `if constexpr`.
+#if defined(WITH_NODE_METRICS)
+inline constexpr bool node_metrics_enabled = true;
+#else
+inline constexpr bool node_metrics_enabled = false;
+#endif
+
+struct NodeMetrics {
+    Time busy_turns = 0;
+    Time idle_turns = 0;
+    std::uint64_t packages_in = 0;
+    std::uint64_t packages_out = 0;
+    // Suma dlugosci kolejki po wszystkich turach - srednia wazona czasem to queue_length_area / liczba tur
+    std::uint64_t queue_length_area = 0;
+    std::size_t max_queue_length = 0;
+
+    Time observed_turns() const { return busy_turns + idle_turns; }
+    double utilization() const;
+    double mean_queue_length() const;
+};
+
+class NodeMetricsRecorder {
+public:
+#if defined(WITH_NODE_METRICS)
+    // Polprodukt przyjety do kolejki (magazynu, bufora rampy), ktora ma teraz `queue_length` elementow
+    void package_in(std::size_t queue_length) {
+        ++metrics_.packages_in;
+        if (queue_length > metrics_.max_queue_length) {
+            metrics_.max_queue_length = queue_length;
+        }
+    }
+    void package_out() { ++metrics_.packages_out; }
+    // Tura pracy robotnika: stan w trakcie tury oraz po niej. Tury pominiete od poprzedniego wywolania
+    // (petle omijajace robotnikow, ktorzy nic by nie zrobili) liczone sa ze stanem, w jakim tamta tura sie skonczyla.
+    void work_turn(Time t, bool busy, std::size_t queue_length, bool busy_after, std::size_t queue_length_after);
+    NodeMetrics get() const { return metrics_; }
+
+private:
+    NodeMetrics metrics_;
+    Time last_turn_ = 0;
+    bool busy_after_ = false;
+    std::size_t queue_length_after_ = 0;
+#else
+    void package_in(std::size_t) {}
+    void package_out() {}
+    void work_turn(Time, bool, std::size_t, bool, std::size_t) {}
+    NodeMetrics get() const { return {}; }
+#endif
+};
+
+#endif //NET_SIMULATION_METRICS_HPP
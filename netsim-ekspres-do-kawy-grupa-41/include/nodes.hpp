@@ -8,13 +8,20 @@
 #include "types.hpp"
 #include "package.hpp"
 #include "storage_types.hpp"
+#include "retention.hpp"
 #include "helpers.hpp"
 #include "config.hpp"
+#include "random.hpp"
+#include "latency.hpp"
+#include "metrics.hpp"
 
+#include <cstdint>
 #include <map>
 #include <optional>
 #include <memory>
 #include <utility>
+#include <variant>
+#include <vector>
 
 
 enum class ReceiverType{
@@ -45,16 +52,45 @@ public:
     virtual ~IPackageReceiver() = default;
 };
 
-class ReceiverPreferences{
+class LinkObserver;
+
+// Odbiorcy wraz z wagami i tablica aliasow - czesc preferencji niezalezna od generatora liczb losowych.
+class ReceiverTable{
 public:
     using preferences_t = std::map<IPackageReceiver*, double>;
     using const_iterator = preferences_t::const_iterator;
 
-    ReceiverPreferences(ProbabilityGenerator rand_ng = probability_generator) : rng_(rand_ng) {}
-    void add_receiver(IPackageReceiver* receiver);
+    void add_receiver(IPackageReceiver* receiver, double weight = 1.0);
+    // Dodaje odbiorce bez przebudowy tablicy aliasow - przed losowaniem trzeba wywolac rebuild().
+    // Przy wczytywaniu wielu polaczen jednego nadawcy oszczedza to przebudowe po kazdym z nich.
+    void add_receiver_deferred(IPackageReceiver* receiver, double weight = 1.0);
     void remove_receiver(IPackageReceiver* receiver);
-    IPackageReceiver* choose_receiver() const;
+    void rebuild();
+    // Wybor odbiorcy dla liczby `u` z [0, 1]. Przy rownych wagach to odbiorca nr floor(u * n) w kolejnosci
+    // get_receivers() (dla u = 1 - ostatni), wiec na granicy przedzialow u = k / n wybierany jest nastepny
+    // odbiorca, a nie poprzedni jak przy dawnym przejsciu po sumach prawdopodobienstw.
+    IPackageReceiver* pick(double u) const;
     const preferences_t& get_preferences() const { return preferences_; }
+    // Typ i ID odbiorcy zapamietane przy przebudowie - pozwalaja przegladac graf bez siegania do obiektow odbiorcow
+    struct ReceiverKey {
+        ReceiverType type;
+        ElementID id;
+    };
+
+    // Odbiorcy w kolejnosci (typ, ID) - ciagla tablica, tansza w przegladaniu niz mapa preferencji
+    const std::vector<IPackageReceiver*>& get_receivers() const { return receivers_; }
+    const std::vector<ReceiverKey>& get_receiver_keys() const { return receiver_keys_; }
+    // Tablica aliasow rownolegla do get_receivers() - do odtworzenia wyboru pick() poza ta klasa
+    const std::vector<double>& get_alias_probabilities() const { return alias_probability_; }
+    const std::vector<std::size_t>& get_aliases() const { return alias_; }
+    double get_weight(IPackageReceiver* receiver) const { return weights_.at(receiver); }
+    bool is_uniform() const;
+    // Liczba przebudow tablicy aliasow - rosnie takze przy zmianie samej wagi (np. CompiledFactory::is_stale)
+    std::uint64_t get_rebuild_count() const { return rebuilds_; }
+
+    // Obserwator dostaje kazde dodanie i usuniecie odbiorcy tego nadawcy (takze juz istniejacych - przy podlaczeniu).
+    // Zmiana samej wagi nie jest zmiana polaczenia i nie jest zglaszana.
+    void set_observer(LinkObserver* observer, SenderType sender_type, ElementID sender_id);
 
     const_iterator begin() const { return preferences_.cbegin(); }
     const_iterator cbegin() const { return preferences_.cbegin(); }
@@ -63,20 +99,74 @@ public:
 
 private:
     preferences_t preferences_;
-    ProbabilityGenerator rng_;
+    preferences_t weights_;
+
+    // Tablica aliasow (Walker/Vose) - wybor odbiorcy w czasie stalym, przebudowywana przy zmianie odbiorcow
+    std::vector<IPackageReceiver*> receivers_;
+    std::vector<ReceiverKey> receiver_keys_;
+    std::vector<double> alias_probability_;
+    std::vector<std::size_t> alias_;
+    std::uint64_t rebuilds_ = 0;
+
+    LinkObserver* observer_ = nullptr;
+    SenderType sender_type_ = SenderType::RAMP;
+    ElementID sender_id_ = 0;
+};
+
+// Zgloszenie niesie klucz odbiorcy i jego adres - samo ID nie odroznia wezla fabryki od obcego o tym samym ID.
+class LinkObserver{
+public:
+    virtual void link_added(SenderType sender_type, ElementID sender_id, ReceiverTable::ReceiverKey key, const IPackageReceiver* receiver) = 0;
+    virtual void link_removed(SenderType sender_type, ElementID sender_id, ReceiverTable::ReceiverKey key, const IPackageReceiver* receiver) = 0;
+
+    virtual ~LinkObserver() = default;
+};
+
+template <class Generator>
+Generator default_generator() { return Generator(); }
+
+template <>
+inline ProbabilityGenerator default_generator<ProbabilityGenerator>() { return probability_generator; }
+
+// Generator jest parametrem szablonu: z RandomStream wywolanie jest bezposrednie (bez std::function).
+// Wezly uzywaja wersji z ProbabilityGenerator, zeby generator mozna bylo podmienic w czasie dzialania.
+template <class Generator = ProbabilityGenerator>
+class BasicReceiverPreferences : public ReceiverTable {
+public:
+    using generator_t = Generator;
+
+    BasicReceiverPreferences(Generator rand_ng = default_generator<Generator>()) : rng_(std::move(rand_ng)) {}
+    IPackageReceiver* choose_receiver() const { return pick(rng_()); }
+
+    const Generator& get_generator() const { return rng_; }
+    void set_generator(Generator rand_ng) { rng_ = std::move(rand_ng); }
+
+private:
+    mutable Generator rng_;
 };
 
+using ReceiverPreferences = BasicReceiverPreferences<>;
+
 class PackageSender{
 public:
     PackageSender() = default;
     PackageSender(PackageSender&&) = default;
     const std::optional<Package>& get_sending_buffer() const { return sending_buffer_; }
-    void send_package();
+    IPackageReceiver* send_package();
+    void send_package_to(IPackageReceiver* receiver);
+    // Odtworzenie bufora z punktu kontrolnego
+    void restore_sending_buffer(Package&& p) { push_package(std::move(p)); }
+    // Wyjecie polproduktu z bufora, gdy odbiorce wybiera i obsluguje kto inny (np. CompiledFactory)
+    Package release_sending_buffer();
     ReceiverPreferences receiver_preferences_;
 
+    // Puste (zera), gdy metryki nie sa wkompilowane - patrz metrics.hpp
+    NodeMetrics get_metrics() const { return metrics_.get(); }
+
 protected:
     void push_package(Package&& p) { sending_buffer_.emplace(std::move(p)); }
     std::optional<Package> sending_buffer_;
+    NodeMetricsRecorder metrics_;
 };
 
 
@@ -84,24 +174,50 @@ class Ramp : public PackageSender{
 public:
     Ramp(ElementID id, TimeOffset di) : PackageSender(), id_(id), di_(di) {}
     void deliver_goods(Time t);
+    bool is_delivery_due(Time t) const { return !((t - 1) % di_); }
+    // Dostawa polproduktu utworzonego poza rampa (np. z ID przydzielonym wczesniej) w turze `t`
+    void deliver_package(Package&& p, Time t) {
+        p.stamp_birth(t, id_);
+        push_package(std::move(p));
+        metrics_.package_in(1);
+    }
     TimeOffset get_delivery_interval() const { return di_; }
     ElementID get_id() const { return id_; }
 
+    // Pula ID nowych polproduktow - ustawiana przez fabryke przy dodawaniu rampy.
+    SimulationContext& get_context() const { return *context_; }
+    void set_context(SimulationContext& context) { context_ = &context; }
+
 private:
     ElementID id_;
     TimeOffset di_;
+    SimulationContext* context_ = &SimulationContext::default_context();
 };
 
 class Worker : public IPackageReceiver, public PackageSender {
 public:
-    Worker(ElementID id, TimeOffset pd, std::unique_ptr<IPackageQueue> q) : PackageSender(), id_(id), pd_(pd), q_(std::move(q)) {}
+    Worker(ElementID id, TimeOffset pd, std::unique_ptr<IPackageQueue> q)
+        : PackageSender(), id_(id), pd_(pd), q_(std::move(q)), queue_view_(resolve_queue(q_.get())) {}
     const std::optional<Package>& get_processing_buffer() const { return processing_buffer_; }
 
     void do_work(Time t);
     Time get_package_processing_start_time() const { return package_processing_start_time_; }
+    // Odtworzenie stanu przetwarzania z punktu kontrolnego
+    void restore_processing_buffer(std::optional<Package>&& p, Time start_time) {
+        processing_buffer_ = std::move(p);
+        package_processing_start_time_ = start_time;
+    }
     IPackageQueue* get_queue() const { return q_.get(); }
+    bool has_queued_packages() const { return std::visit([](const auto* q) { return !q->empty(); }, queue_view_); }
     TimeOffset get_processing_duration() const { return pd_; }
-    void receive_package(Package&& p) override { q_->push(std::move(p)); }
+    void receive_package(Package&& p) override {
+        std::visit([this, &p](auto* q) {
+            q->push(std::move(p));
+            if constexpr (node_metrics_enabled) {
+                metrics_.package_in(q->size());
+            }
+        }, queue_view_);
+    }
     ElementID get_id() const override { return id_; }
 
     #if (defined EXERCISE_ID && EXERCISE_ID != EXERCISE_ID_NODES)
@@ -115,13 +231,21 @@ public:
 
 
 private:
+    // Kolejka widziana bez posrednictwa metod wirtualnych, gdy jest zwykla PackageQueue;
+    // inne implementacje IPackageQueue (np. mocki) obslugiwane sa przez interfejs.
+    using queue_view_t = std::variant<IPackageQueue*, FifoQueue*, LifoQueue*>;
+    static queue_view_t resolve_queue(IPackageQueue* q);
+    template <class Queue>
+    void do_work_on(Queue& q, Time t);
+
     #if (defined EXERCISE_ID && EXERCISE_ID != EXERCISE_ID_NODES)
         ReceiverType rt_ = ReceiverType::WORKER;
     #endif
-    Time package_processing_start_time_;
+    Time package_processing_start_time_ = 0;
     ElementID id_;
     TimeOffset pd_;
     std::unique_ptr<IPackageQueue> q_;
+    queue_view_t queue_view_;
     std::optional<Package> processing_buffer_;
 };
 
@@ -129,8 +253,27 @@ class Storehouse : public IPackageReceiver{
 public:
     explicit Storehouse(ElementID id, std::unique_ptr<IPackageStockpile> d = std::make_unique<PackageQueue>(PackageQueueType::FIFO)) : id_(id), d_(std::move(d)) {}
 
-    void receive_package(Package&& p) override { d_->push(std::move(p)); }
+    void receive_package(Package&& p) override {
+        if constexpr (package_latency_enabled) {
+            latency_.record(p.get_origin(), p.get_age());
+        }
+        d_->push(std::move(p));
+        if constexpr (node_metrics_enabled) {
+            metrics_.package_in(d_->stored_count());
+        }
+    }
+    // Odtworzenie zawartosci (checkpoint.hpp) - bez pomiaru opoznien i metryk, bo polprodukt byl juz przyjety
+    void restore_stock(Package&& p) { d_->push(std::move(p)); }
     ElementID get_id() const override { return id_; }
+    // Liczba wszystkich przyjetych polproduktow - przy polityce przechowywania z retention.hpp moze byc
+    // wieksza od liczby polproduktow dostepnych przez iteratory
+    std::uint64_t get_received_count() const { return d_->received_count(); }
+    // Polprodukty przeniesione do pliku przy polityce SPILL (retention.hpp) - poprzedzaja te z iteratorow
+    PackageIdRange spilled_ids() const { return d_->spilled_ids(); }
+    const IPackageStockpile* get_stockpile() const { return d_.get(); }
+    NodeMetrics get_metrics() const { return metrics_.get(); }
+    // Opoznienia przyjetych polproduktow - puste, gdy pomiar nie jest wkompilowany (latency.hpp)
+    const LatencyRecorder& get_latency() const { return latency_; }
 
     #if (defined EXERCISE_ID && EXERCISE_ID != EXERCISE_ID_NODES)
         ReceiverType get_receiver_type() const override { return rt_; }
@@ -147,6 +290,8 @@ private:
     #endif
     ElementID id_;
     std::unique_ptr<IPackageStockpile> d_;
+    NodeMetricsRecorder metrics_;
+    LatencyRecorder latency_;
 };
 
 
@@ -0,0 +1,134 @@
+#ifndef NET_SIMULATION_OUTPUT_SINKS_HPP
+#define NET_SIMULATION_OUTPUT_SINKS_HPP
+
+#include "reports.hpp"
+
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class OutputFormat {
+    JSONL,
+    CSV,
+    COLUMNAR
+};
+
+// "jsonl", "csv" albo "columnar"; dla innej nazwy rzuca std::invalid_argument
+OutputFormat parse_output_format(std::string_view name);
+
+enum class NodeKind : std::uint8_t {
+    WORKER,
+    STOREHOUSE
+};
+
+// Stan wezla po turze. Pola, ktorych dany rodzaj wezla nie ma (bufory i kolejka magazynu, liczba polproduktow
+// przyjetych przez robotnika), maja wartosc -1 dla ID i 0 dla liczb.
+struct NodeTurnRecord {
+    Time turn;
+    NodeKind kind;
+    ElementID id;
+    std::uint32_t queue_length;
+    ElementID processing_id;
+    ElementID sending_id;
+    // Storehouse::get_received_count() - niezalezne od polityki przechowywania (retention.hpp)
+    std::uint64_t stock_count;
+};
+
+// Stan fabryki po turze w postaci do dalszej obrobki - zamiast parsowania raportow tekstowych. Obiekt podaje sie
+// jako `rf` (std::ref(sink)), wiec wybor formatu nie zmienia kodu symulacji. W kazdej turze robotnicy, potem
+// magazyny, wg ID. Zapis idzie do bufora wielokrotnego uzytku, oproznianego do strumienia po przekroczeniu
+// `buffer_size` bajtow, w flush() i przy zniszczeniu - bez alokacji na rekord. Gdy strumien po zapisie jest
+// w stanie bledu, write() i flush() rzucaja std::ios_base::failure.
+class TurnOutputSink {
+public:
+    explicit TurnOutputSink(std::ostream& os, std::size_t buffer_size = 64 * 1024);
+    TurnOutputSink(const TurnOutputSink&) = delete;
+    TurnOutputSink& operator=(const TurnOutputSink&) = delete;
+    // Zapisuje reszte bufora; bledy zapisu sa wtedy pomijane - aby je dostac, trzeba wczesniej wywolac flush()
+    virtual ~TurnOutputSink();
+
+    void operator()(Factory& f, Time t) { write(f, t); }
+    void write(const Factory& f, Time t);
+    // Przekazuje zbuforowane dane do strumienia (samego strumienia nie oproznia)
+    virtual void flush();
+
+protected:
+    virtual void begin_turn(Time) {}
+    virtual void write_record(const NodeTurnRecord& record) = 0;
+    virtual void end_turn() {}
+
+    void append(std::string_view text) { buffer_.append(text); }
+    void append_number(long long value);
+    void append_bytes(const void* data, std::size_t size) { buffer_.append(static_cast<const char*>(data), size); }
+    void write_buffer();
+
+private:
+    std::ostream* os_;
+    std::size_t buffer_size_;
+    std::string buffer_;
+    NodeOrder order_;
+};
+
+// Jeden obiekt JSON w wierszu na ture: {"turn":T,"nodes":[{"kind":"worker","id":..,"queue":..,
+// "processing":..,"sending":..},{"kind":"storehouse","id":..,"stock":..}]}; pusty bufor to null.
+class JsonLinesSink : public TurnOutputSink {
+public:
+    using TurnOutputSink::TurnOutputSink;
+
+protected:
+    void begin_turn(Time t) override;
+    void write_record(const NodeTurnRecord& record) override;
+    void end_turn() override;
+
+private:
+    void append_id(ElementID id);
+
+    bool first_node_ = true;
+};
+
+// Wiersz na wezel i ture, z naglowkiem: turn,kind,id,queue_length,processing_id,sending_id,stock_count;
+// pola, ktorych wezel nie ma, sa puste.
+class CsvSink : public TurnOutputSink {
+public:
+    explicit CsvSink(std::ostream& os, std::size_t buffer_size = 64 * 1024);
+
+protected:
+    void write_record(const NodeTurnRecord& record) override;
+};
+
+// Binarny format kolumnowy: naglowek "NSCO" i wersja (uint32), dalej bloki po co najwyzej `block_rows` wierszy -
+// liczba wierszy (uint32), a po niej kolejno kolumny pol NodeTurnRecord: turn (int32), kind (uint8), id (int32),
+// queue_length (uint32), processing_id (int32), sending_id (int32), stock_count (uint64).
+// Liczby zapisywane sa w natywnym porzadku bajtow (jak w checkpoint.hpp). Odczyt - read_columnar_output().
+class ColumnarSink : public TurnOutputSink {
+public:
+    explicit ColumnarSink(std::ostream& os, std::size_t block_rows = 4096);
+    ~ColumnarSink() override;
+
+    // Zamyka biezacy (niepelny) blok
+    void flush() override;
+
+protected:
+    void write_record(const NodeTurnRecord& record) override;
+
+private:
+    std::size_t block_rows_;
+    std::vector<std::int32_t> turns_;
+    std::vector<NodeKind> kinds_;
+    std::vector<std::int32_t> ids_;
+    std::vector<std::uint32_t> queue_lengths_;
+    std::vector<std::int32_t> processing_ids_;
+    std::vector<std::int32_t> sending_ids_;
+    std::vector<std::uint64_t> stock_counts_;
+};
+
+std::unique_ptr<TurnOutputSink> make_output_sink(OutputFormat format, std::ostream& os);
+
+// Wszystkie wiersze zapisane przez ColumnarSink; rzuca std::runtime_error dla uszkodzonego lub niezgodnego pliku
+std::vector<NodeTurnRecord> read_columnar_output(std::istream& is);
+
+#endif //NET_SIMULATION_OUTPUT_SINKS_HPP
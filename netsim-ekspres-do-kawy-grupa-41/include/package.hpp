@@ -6,23 +6,63 @@
 #define NET_SIMULATION_PACKAGE_HPP
 
 #include "types.hpp"
-#include <set>
+#include "latency.hpp"
+#include "simulation_context.hpp"
+#include <algorithm>
 
 class Package{
 public:
 
-    Package();
-    explicit Package(ElementID ID) : ID_(ID) {}
-    Package(Package&& other) : ID_(std::move(other.get_id())) {}
+    Package() : Package(SimulationContext::default_context()) {}
+    explicit Package(SimulationContext& context);
+    explicit Package(ElementID ID) : Package(ID, SimulationContext::default_context()) {}
+    // Przejmuje ID przydzielone wczesniej z puli `context` - zostanie do niej zwrocone przy zniszczeniu.
+    Package(ElementID ID, SimulationContext& context) : ID_(ID), context_(&context) {}
+    Package(Package&& other) noexcept : ID_(other.ID_), context_(other.context_) {
+#if defined(WITH_PACKAGE_LATENCY)
+        birth_time_ = other.birth_time_;
+        origin_ = other.origin_;
+#endif
+        other.ID_ = Package::invalid_id;
+    }
     ~Package();
 
     Package& operator=(Package&& other) noexcept;
     ElementID get_id() const { return ID_; }
+    // Konczy udzial polproduktu w symulacji bez zwracania ID do puli - ID pozostaje zajete, tak jakby
+    // polprodukt nadal lezal w magazynie. Zwraca to ID.
+    ElementID retire() {
+        ElementID ID = ID_;
+        ID_ = Package::invalid_id;
+        return ID;
+    }
+
+    // Czas i rampa dostawy - nadawane przez rampe, gdy wkompilowany jest pomiar opoznien (latency.hpp);
+    // bez niego metody sa puste i zwracaja 0.
+#if defined(WITH_PACKAGE_LATENCY)
+    void stamp_birth(Time t, ElementID origin) {
+        birth_time_ = t;
+        origin_ = origin;
+    }
+    Time get_birth_time() const { return birth_time_; }
+    ElementID get_origin() const { return origin_; }
+    // Liczba tur od dostawy do biezacej tury kontekstu; 0, gdy tura kontekstu jest wczesniejsza niz dostawa
+    // (np. nie zostala ustawiona) - ujemny wiek trafilby po rzutowaniu do najwyzszego przedzialu histogramu
+    Time get_age() const { return std::max<Time>(context_->get_turn() - birth_time_, 0); }
+#else
+    void stamp_birth(Time, ElementID) {}
+    Time get_birth_time() const { return 0; }
+    ElementID get_origin() const { return 0; }
+    Time get_age() const { return 0; }
+#endif
 
-    inline static std::set<ElementID> assigned_IDs;
-    inline static std::set<ElementID> freed_IDs;
 private:
     ElementID ID_;
+    SimulationContext* context_;
+#if defined(WITH_PACKAGE_LATENCY)
+    Time birth_time_ = 0;
+    ElementID origin_ = 0;
+#endif
     inline static ElementID invalid_id = -1;
     bool is_id_valid() const { return ID_ != Package::invalid_id; }
 };
@@ -0,0 +1,50 @@
+#ifndef NET_SIMULATION_RANDOM_HPP
+#define NET_SIMULATION_RANDOM_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Generator licznikowy Philox4x32-10 (Salmon i in., "Parallel random numbers: as easy as 1, 2, 3").
+// Wynik zalezy wylacznie od klucza i licznika, wiec dowolny fragment dowolnego strumienia
+// mozna policzyc niezaleznie - bez wspolnego stanu miedzy strumieniami.
+class Philox4x32 {
+public:
+    using counter_t = std::array<std::uint32_t, 4>;
+    using key_t = std::array<std::uint32_t, 2>;
+
+    static counter_t generate(counter_t counter, key_t key);
+};
+
+// Strumien liczb z [0, 1) wyznaczony przez ziarno (klucz Philoxa) i numer strumienia (gorna polowa licznika).
+// Liczby generowane sa paczkami do bufora - jedno wywolanie to zwykle tylko odczyt z tablicy.
+class RandomStream {
+public:
+    static constexpr std::size_t batch_size = 64;
+
+    explicit RandomStream(std::uint64_t seed = 0, std::uint64_t stream = 0);
+
+    double operator()() {
+        if (position_in_batch_ == batch_size) {
+            refill();
+        }
+        return buffer_[position_in_batch_++];
+    }
+
+    std::uint64_t get_seed() const { return seed_; }
+    std::uint64_t get_stream() const { return stream_; }
+    // Liczba wylosowanych dotad wartosci; seek() pozwala wznowic strumien od zadanej pozycji.
+    std::uint64_t get_position() const { return batch_ * batch_size - (batch_size - position_in_batch_); }
+    void seek(std::uint64_t position);
+
+private:
+    void refill();
+
+    std::uint64_t seed_;
+    std::uint64_t stream_;
+    std::uint64_t batch_ = 0;
+    std::size_t position_in_batch_ = batch_size;
+    std::array<double, batch_size> buffer_{};
+};
+
+#endif //NET_SIMULATION_RANDOM_HPP
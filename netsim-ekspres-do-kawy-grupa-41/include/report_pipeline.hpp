@@ -0,0 +1,66 @@
+#ifndef NET_SIMULATION_REPORT_PIPELINE_HPP
+#define NET_SIMULATION_REPORT_PIPELINE_HPP
+
+#include "reports.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+// Raporty tur formatowane i zapisywane do strumienia na osobnym watku. submit() (wolane z `rf` symulacji)
+// robi tylko zrzut stanu (TurnSnapshot) do jednego z `slots` zrzutow utworzonych z gory i wraca - pamiec
+// zrzutow jest ponownie uzywana. Gdy wszystkie zrzuty czekaja na zapis (pisarz nie nadaza), submit() czeka
+// na zwolnienie najstarszego. Raporty trafiaja do `os` w kolejnosci submit(), w tej samej postaci co
+// z generate_simulation_turn_report(); strumienia nie wolno uzywac poza potokiem, dopoki drain() nie wroci.
+class ReportPipeline {
+public:
+    explicit ReportPipeline(std::ostream& os, std::size_t slots = 2);
+    ReportPipeline(const ReportPipeline&) = delete;
+    ReportPipeline& operator=(const ReportPipeline&) = delete;
+    // Zapisuje oczekujace raporty; bledy zapisu sa wtedy pomijane - aby je dostac, trzeba wczesniej wywolac drain()
+    ~ReportPipeline();
+
+    // Rzuca wyjatek z zapisu ktoregos z wczesniejszych raportow
+    void submit(const Factory& f, Time t);
+    void operator()(Factory& f, Time t) { submit(f, t); }
+    // Czeka na zapis wszystkich przekazanych raportow; rzuca wyjatek z zapisu, jesli taki wystapil
+    void drain();
+
+    // Ile razy submit() czekalo na wolny zrzut
+    std::uint64_t get_stall_count() const;
+
+private:
+    void writer_loop();
+    void rethrow_error();
+
+    std::ostream* os_;
+    std::vector<TurnSnapshot> slots_;
+    mutable std::mutex mutex_;
+    std::condition_variable submitted_cv_;
+    std::condition_variable written_cv_;
+    std::uint64_t submitted_ = 0;
+    std::uint64_t written_ = 0;
+    std::uint64_t stalls_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+    std::thread writer_;
+};
+
+// `rf` dla simulate*(): raport tury przez potok, gdy wskaze go `notifier` (IntervalReportNotifier,
+// SpecificTurnsReportNotifier). Dla simulate_event_driven() wystarczy przekazac sam potok jako `rf`
+// i make_report_schedule(notifier) jako harmonogram.
+template <class Notifier>
+std::function<void(Factory&, Time)> make_pipeline_report_function(ReportPipeline& pipeline, Notifier& notifier) {
+    return [&pipeline, &notifier](Factory& f, Time t) {
+        if (notifier.should_generate_report(t)) {
+            pipeline.submit(f, t);
+        }
+    };
+}
+
+#endif //NET_SIMULATION_REPORT_PIPELINE_HPP
@@ -6,6 +6,18 @@
 #define NET_SIMULATION_REPORTS_HPP
 
 #include "factory.hpp"
+#include "fast_forward.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class PackageSpillFile;
 
 struct ProcessedReceiverPreferences{
     std::vector<std::pair<ElementID, std::string>> mapping_receiver_worker;
@@ -16,11 +28,90 @@ ProcessedReceiverPreferences sort_preferences(const ReceiverPreferences::prefere
 
 void generate_structure_report(const Factory& f,std::ostream& os);
 void generate_simulation_turn_report(const Factory& f,std::ostream& os,Time t);
+// Tabela metryk wezlow (patrz metrics.hpp), wezly kazdego rodzaju rosnaco po ID
+void generate_metrics_summary(const Factory& f, std::ostream& os);
+// Percentyle opoznien (patrz latency.hpp) dla kazdego magazynu: lacznie i osobno dla kazdej rampy zrodlowej
+void generate_latency_summary(const Factory& f, std::ostream& os);
+// Podsumowanie tur pominietych przez simulate_fast_forward() - w miejsce ich raportow
+void generate_fast_forward_report(const FastForwardSpan& span, std::ostream& os);
+
+// Robotnicy i magazyny fabryki uporzadkowani wg ID - kolejnosc liczona jest raz i odswiezana tylko
+// przy zmianie struktury fabryki.
+class NodeOrder{
+public:
+    void refresh(const Factory& f);
+    const std::vector<const Worker*>& get_workers() const { return workers_; }
+    const std::vector<const Storehouse*>& get_storehouses() const { return storehouses_; }
+
+private:
+    const Factory* factory_ = nullptr;
+    std::uint64_t topology_version_ = 0;
+    std::vector<const Worker*> workers_;
+    std::vector<const Storehouse*> storehouses_;
+};
+
+// Stan robotnikow i magazynow potrzebny do raportu tury, skopiowany do plaskich tablic wielokrotnego uzytku -
+// po capture() raport mozna sformatowac bez dostepu do fabryki (np. na innym watku, patrz report_pipeline.hpp).
+// ID przeniesione przez magazyn do pliku (polityka SPILL) nie sa kopiowane: zrzut pamieta tylko ich liczbe
+// i plik, z ktorego czyta je dopiero zapis raportu. Wezly sa uporzadkowane wg ID.
+class TurnSnapshot{
+public:
+    struct WorkerState {
+        ElementID id;
+        std::optional<ElementID> processing;
+        Time processing_time;
+        std::optional<ElementID> sending;
+        // Kolejka - zakres w get_ids()
+        std::size_t queue_begin;
+        std::size_t queue_end;
+    };
+    struct StorehouseState {
+        ElementID id;
+        // Zawartosc magazynu: `spilled` pierwszych ID z pliku `spill`, potem zakres w get_ids()
+        std::shared_ptr<const PackageSpillFile> spill;
+        std::size_t spilled;
+        std::size_t stock_begin;
+        std::size_t stock_end;
+    };
+
+    void capture(const Factory& f, Time t);
+
+    Time get_turn() const { return turn_; }
+    const std::vector<WorkerState>& get_workers() const { return worker_states_; }
+    const std::vector<StorehouseState>& get_storehouses() const { return storehouse_states_; }
+    const std::vector<ElementID>& get_ids() const { return ids_; }
+
+private:
+    NodeOrder order_;
+    Time turn_ = 0;
+    std::vector<WorkerState> worker_states_;
+    std::vector<StorehouseState> storehouse_states_;
+    std::vector<ElementID> ids_;
+};
+
+// Raport tury skladany bezposrednio w buforze wielokrotnego uzytku (std::to_chars, bez tymczasowych napisow).
+// Strumien nie jest oprozniany po kazdej turze.
+class TurnReportWriter{
+public:
+    void write(const Factory& f, std::ostream& os, Time t);
+    void write(const TurnSnapshot& snapshot, std::ostream& os);
+
+private:
+    void append(std::string_view text) { buffer_.append(text); }
+    void append_number(long long value);
+    void append_ids(const std::vector<ElementID>& ids, std::size_t begin, std::size_t end);
+    void append_stock(const TurnSnapshot::StorehouseState& storehouse, const std::vector<ElementID>& ids);
+
+    TurnSnapshot snapshot_;
+    std::string buffer_;
+    std::vector<ElementID> spilled_;
+};
 
 class IntervalReportNotifier{
 public:
     IntervalReportNotifier(TimeOffset to) : to_(to) {}
     bool should_generate_report(Time t) { return !static_cast<bool>((t - 1) % to_); }
+    Time next_report_turn(Time t) const { return t + (to_ - (t - 1) % to_) % to_; }
 
 private:
     TimeOffset to_;
@@ -30,6 +121,10 @@ class SpecificTurnsReportNotifier{
 public:
     SpecificTurnsReportNotifier(std::set<Time> turns) : turns_(turns) {}
     bool should_generate_report(Time t) { return turns_.find(t) != turns_.end(); }
+    Time next_report_turn(Time t) const {
+        auto it = turns_.lower_bound(t);
+        return it == turns_.end() ? std::numeric_limits<Time>::max() : *it;
+    }
 
 private:
     std::set<Time> turns_;
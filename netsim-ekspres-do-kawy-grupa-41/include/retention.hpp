@@ -0,0 +1,105 @@
+#ifndef NET_SIMULATION_RETENTION_HPP
+#define NET_SIMULATION_RETENTION_HPP
+
+#include "storage_types.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class RetentionPolicy {
+    COUNT_ONLY,
+    KEEP_LAST,
+    SPILL
+};
+
+// Dopisywany plik ID polproduktow wyrzuconych z pamieci magazynu (surowa tablica ElementID w porzadku
+// przyjecia). Kazda partia idzie jednym zapisem, po ktorym odnawiane jest odwzorowanie pliku w pamieci -
+// odczyt przez ids() nie wykonuje juz zadnych operacji na pliku.
+class PackageSpillFile {
+public:
+    // Pusta sciezka - plik tymczasowy w $TMPDIR (albo /tmp) usuwany zaraz po otwarciu.
+    // Rzuca std::runtime_error, gdy pliku nie da sie utworzyc.
+    explicit PackageSpillFile(const std::string& path = "");
+    PackageSpillFile(const PackageSpillFile&) = delete;
+    PackageSpillFile& operator=(const PackageSpillFile&) = delete;
+    ~PackageSpillFile();
+
+    std::size_t size() const { return mapped_; }
+    const std::string& get_path() const { return path_; }
+    // Rzuca std::runtime_error, gdy zapis lub odwzorowanie sie nie uda; wczesniejsze ids() traca waznosc
+    void append(const std::vector<ElementID>& ids);
+    PackageIdRange ids() const { return PackageIdRange(static_cast<const ElementID*>(data_), mapped_); }
+    // Czyta ID [first, first + count) wprost z pliku, bez odwzorowania - zapisane ID sie nie zmieniaja, wiec mozna
+    // to robic na innym watku rownolegle z append() (np. raport tury, report_pipeline.hpp).
+    // Rzuca std::runtime_error, gdy odczyt sie nie uda.
+    void read(std::size_t first, std::size_t count, ElementID* out) const;
+
+private:
+    void map(std::size_t size);
+    void unmap();
+
+    int fd_ = -1;
+    std::string path_;
+    std::size_t written_ = 0;
+    void* data_ = nullptr;
+    std::size_t mapped_ = 0;
+};
+
+// Magazyn o ograniczonej pamieci (IPackageStockpile dla Storehouse):
+//  - COUNT_ONLY - tylko liczy przyjete polprodukty,
+//  - KEEP_LAST - trzyma `keep` ostatnich,
+//  - SPILL - trzyma co najmniej `keep` ostatnich, a starsze przenosi partiami po spill_batch_size
+//    do pliku `spill_path` (patrz PackageSpillFile). Iteratory obejmuja polprodukty w pamieci,
+//    a wczesniejsze ID podaje spilled_ids().
+// Usuniete z pamieci polprodukty nie zwracaja ID do puli (Package::retire), wiec przebieg symulacji
+// nie zalezy od polityki. size() - jak iteratory - obejmuje tylko polprodukty w pamieci, stored_count()
+// takze te w pliku.
+class RetainingStockpile : public IPackageStockpile {
+public:
+    static constexpr std::size_t spill_batch_size = 4096;
+
+    explicit RetainingStockpile(RetentionPolicy policy, std::size_t keep = 0, const std::string& spill_path = "");
+    // Dopisuje do nazwanego pliku SPILL polprodukty ponad `keep` (jak flush()); destruktor nie moze rzucic,
+    // wiec blad zapisu trafia tylko na std::cerr - kto chce go obsluzyc, wola wczesniej flush()
+    ~RetainingStockpile() override;
+
+    std::size_t size() const override { return recent_.size(); }
+    bool empty() const override { return recent_.empty(); }
+    std::size_t stored_count() const override { return spilled_ids().size() + recent_.size(); }
+    // Przenosi do pliku SPILL wszystkie polprodukty ponad `keep`, takze niepelna partie (bez SPILL nic nie robi).
+    // Rzuca std::runtime_error, gdy zapis sie nie uda - polprodukty zostaja wtedy w pamieci.
+    void flush();
+    void push(Package&& package) override;
+    std::uint64_t received_count() const override { return received_; }
+    PackageIdRange spilled_ids() const override { return spill_ ? spill_->ids() : PackageIdRange(); }
+    RetentionPolicy get_policy() const { return policy_; }
+    std::size_t get_keep() const { return keep_; }
+    std::string get_spill_path() const { return spill_ ? spill_->get_path() : std::string(); }
+    // Plik SPILL (nullptr dla innych polityk) - wspoldzielony, wiec pozostaje otwarty dla czytajacych go po zniszczeniu magazynu
+    std::shared_ptr<const PackageSpillFile> get_spill_file() const { return spill_; }
+
+    // Odtwarzanie stanu z punktu kontrolnego (checkpoint.hpp): najpierw ID z pliku (tylko SPILL), potem push()
+    // polproduktow z pamieci, na koniec liczba przyjetych.
+    // Rzuca std::logic_error, gdy polityka nie jest SPILL.
+    void restore_spilled_ids(const std::vector<ElementID>& ids);
+    void restore_received_count(std::uint64_t received) { received_ = received; }
+
+    const_iterator begin() const override { return recent_.cbegin(); }
+    const_iterator cbegin() const override { return recent_.cbegin(); }
+    const_iterator end() const override { return recent_.cend(); }
+    const_iterator cend() const override { return recent_.cend(); }
+
+private:
+    void spill(std::size_t count);
+
+    RetentionPolicy policy_;
+    std::size_t keep_;
+    PackageRingBuffer recent_;
+    std::shared_ptr<PackageSpillFile> spill_;
+    std::vector<ElementID> batch_;
+    std::uint64_t received_ = 0;
+};
+
+#endif //NET_SIMULATION_RETENTION_HPP
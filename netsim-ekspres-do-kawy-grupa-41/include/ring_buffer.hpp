@@ -0,0 +1,108 @@
+#ifndef NET_SIMULATION_RING_BUFFER_HPP
+#define NET_SIMULATION_RING_BUFFER_HPP
+
+#include "package.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+
+// Iterator po ciaglym buforze cyklicznym polproduktow - pozycja liczona jest od poczatku kolejki,
+// a indeks w pamieci wyznacza maska (pojemnosc bufora jest zawsze potega dwojki).
+class PackageRingIterator {
+public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = Package;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Package*;
+    using reference = const Package&;
+
+    PackageRingIterator() = default;
+    PackageRingIterator(const Package* data, std::size_t mask, std::size_t head, std::size_t pos)
+        : data_(data), mask_(mask), head_(head), pos_(pos) {}
+
+    reference operator*() const { return data_[(head_ + pos_) & mask_]; }
+    pointer operator->() const { return &**this; }
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    PackageRingIterator& operator++() { ++pos_; return *this; }
+    PackageRingIterator operator++(int) { auto it = *this; ++pos_; return it; }
+    PackageRingIterator& operator--() { --pos_; return *this; }
+    PackageRingIterator operator--(int) { auto it = *this; --pos_; return it; }
+    PackageRingIterator& operator+=(difference_type n) { pos_ += n; return *this; }
+    PackageRingIterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+
+    friend PackageRingIterator operator+(PackageRingIterator it, difference_type n) { return it += n; }
+    friend PackageRingIterator operator+(difference_type n, PackageRingIterator it) { return it += n; }
+    friend PackageRingIterator operator-(PackageRingIterator it, difference_type n) { return it -= n; }
+    friend difference_type operator-(const PackageRingIterator& a, const PackageRingIterator& b) {
+        return static_cast<difference_type>(a.pos_) - static_cast<difference_type>(b.pos_);
+    }
+
+    friend bool operator==(const PackageRingIterator& a, const PackageRingIterator& b) { return a.pos_ == b.pos_ && a.data_ == b.data_; }
+    friend bool operator!=(const PackageRingIterator& a, const PackageRingIterator& b) { return !(a == b); }
+    friend bool operator<(const PackageRingIterator& a, const PackageRingIterator& b) { return a.pos_ < b.pos_; }
+    friend bool operator>(const PackageRingIterator& a, const PackageRingIterator& b) { return b < a; }
+    friend bool operator<=(const PackageRingIterator& a, const PackageRingIterator& b) { return !(b < a); }
+    friend bool operator>=(const PackageRingIterator& a, const PackageRingIterator& b) { return !(a < b); }
+
+private:
+    const Package* data_ = nullptr;
+    std::size_t mask_ = 0;
+    std::size_t head_ = 0;
+    std::size_t pos_ = 0;
+};
+
+// Rosnacy bufor cykliczny polproduktow: jedna ciagla tablica zamiast osobnego wezla na kazdy polprodukt.
+// Pobieranie dziala z obu koncow, wiec ten sam bufor obsluguje kolejke FIFO i LIFO.
+class PackageRingBuffer {
+public:
+    using const_iterator = PackageRingIterator;
+
+    PackageRingBuffer() = default;
+    PackageRingBuffer(PackageRingBuffer&& other) noexcept;
+    PackageRingBuffer& operator=(PackageRingBuffer&& other) noexcept;
+    ~PackageRingBuffer();
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+    void push_back(Package&& package) {
+        if (size_ == capacity_) {
+            grow();
+        }
+        new (data_ + ((head_ + size_) & (capacity_ - 1))) Package(std::move(package));
+        ++size_;
+    }
+
+    Package pop_front() {
+        Package& front = data_[head_];
+        Package output(std::move(front));
+        front.~Package();
+        head_ = (head_ + 1) & (capacity_ - 1);
+        --size_;
+        return output;
+    }
+
+    Package pop_back() {
+        Package& back = data_[(head_ + size_ - 1) & (capacity_ - 1)];
+        Package output(std::move(back));
+        back.~Package();
+        --size_;
+        return output;
+    }
+
+    const_iterator cbegin() const { return const_iterator(data_, capacity_ - 1, head_, 0); }
+    const_iterator cend() const { return const_iterator(data_, capacity_ - 1, head_, size_); }
+
+private:
+    void grow();
+    void clear();
+
+    Package* data_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+};
+
+#endif //NET_SIMULATION_RING_BUFFER_HPP
@@ -8,9 +8,46 @@
 #include <utility>
 
 #include "factory.hpp"
+#include "compiled_factory.hpp"
+#include "fast_forward.hpp"
 #include "reports.hpp"
 #include <set>
 
+// Przy wkompilowanych metrykach (WITH_NODE_METRICS) lub pomiarze opoznien (WITH_PACKAGE_LATENCY) kazda
+// z funkcji simulate*() wypisuje na koniec ich tabele do tego strumienia, o ile jest ustawiony.
+extern thread_local std::ostream* metrics_summary_output;
+
+// Dla danej tury zwraca najblizsza (nie wczesniejsza) ture, w ktorej nalezy wygenerowac raport.
+using ReportSchedule = std::function<Time(Time)>;
+
 void simulate(Factory& f, TimeOffset d, std::function<void(Factory&, Time)> rf);
 
+// Tury od `start` do d - 1 - np. wznowienie symulacji z punktu kontrolnego zapisanego po turze start - 1.
+void simulate_from(Factory& f, Time start, TimeOffset d, std::function<void(Factory&, Time)> rf);
+
+// Jak wyzej, ale dostawy, przekazywanie polproduktow i praca robotnikow wykonywane sa na watkach z `pool`.
+void simulate(Factory& f, TimeOffset d, std::function<void(Factory&, Time)> rf, ThreadPool& pool);
+
+// Na skompilowanym ukladzie fabryki (wyniki jak w simulate() dla fabryki zrodlowej, ktora dostaje `rf`).
+// Rzuca std::logic_error, gdy fabryka zmienila sie po kompilacji.
+void simulate(CompiledFactory& f, TimeOffset d, std::function<void(Factory&, Time)> rf);
+
+// Symulacja zdarzeniowa - daje te same wyniki co simulate(), ale pomija tury, w ktorych nic sie nie dzieje:
+// dostawy ramp i konce przetwarzania u robotnikow trzymane sa w kolejce priorytetowej.
+// Bez harmonogramu raportow `rf` wywolywana jest w kazdej turze, tak jak w simulate().
+void simulate_event_driven(Factory& f, TimeOffset d, std::function<void(Factory&, Time)> rf, ReportSchedule schedule = nullptr);
+
+// Jak simulate(), ale po potwierdzeniu, ze stan fabryki powtarza sie okresowo (patrz PeriodicFastForward),
+// przeskakuje cale okresy do konca symulacji. Dla pominietych tur `rf` nie jest wywolywana - zamiast tego
+// `on_skip` dostaje fabryke w stanie po ostatniej pominietej turze i opis przeskoku.
+// Stan koncowy jest taki sam jak po simulate(); dla sieci, ktorych nie da sie przeskoczyc, to po prostu simulate().
+void simulate_fast_forward(Factory& f, TimeOffset d, std::function<void(Factory&, Time)> rf,
+                           std::function<void(Factory&, const FastForwardSpan&)> on_skip = nullptr);
+
+// Harmonogram przechowuje kopie notyfikatora, wiec moze on byc obiektem tymczasowym.
+template <class Notifier>
+ReportSchedule make_report_schedule(Notifier notifier) {
+    return [notifier = std::move(notifier)](Time t) { return notifier.next_report_turn(t); };
+}
+
 #endif //NET_SIMULATION_SIMULATE_HPP
@@ -0,0 +1,31 @@
+#ifndef NET_SIMULATION_SIMULATION_CONTEXT_HPP
+#define NET_SIMULATION_SIMULATION_CONTEXT_HPP
+
+#include "id_allocator.hpp"
+#include "types.hpp"
+
+// Stan wspolny dla jednej symulacji (pula ID polproduktow i biezaca tura). Kazda fabryka ma wlasny kontekst,
+// wiec niezalezne fabryki mozna symulowac rownolegle na osobnych watkach bez zadnej synchronizacji.
+class SimulationContext {
+public:
+    SimulationContext() = default;
+    SimulationContext(const SimulationContext&) = delete;
+    SimulationContext& operator=(const SimulationContext&) = delete;
+
+    IdAllocator& id_allocator() { return id_allocator_; }
+    const IdAllocator& id_allocator() const { return id_allocator_; }
+
+    // Tura ustawiana przez dostawy (Factory::do_deliveries i petle symulacji) - z niej liczone jest
+    // opoznienie polproduktow przyjmowanych przez magazyny.
+    Time get_turn() const { return turn_; }
+    void set_turn(Time t) { turn_ = t; }
+
+    // Kontekst polproduktow tworzonych poza fabryka (osobny dla kazdego watku).
+    static SimulationContext& default_context();
+
+private:
+    IdAllocator id_allocator_;
+    Time turn_ = 0;
+};
+
+#endif //NET_SIMULATION_SIMULATION_CONTEXT_HPP
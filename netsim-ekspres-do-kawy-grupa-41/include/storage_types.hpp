@@ -7,18 +7,43 @@
 
 
 #include "package.hpp"
+#include "ring_buffer.hpp"
 
-#include <list>
+#include <cstdint>
 #include <utility>
+#include <variant>
+
+// Ciagla tablica ID polproduktow przechowywanych poza pamiecia (np. odwzorowany plik magazynu - retention.hpp)
+class PackageIdRange {
+public:
+    PackageIdRange() = default;
+    PackageIdRange(const ElementID* first, std::size_t size) : first_(first), size_(size) {}
+
+    const ElementID* begin() const { return first_; }
+    const ElementID* end() const { return first_ + size_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    const ElementID* first_ = nullptr;
+    std::size_t size_ = 0;
+};
 
 class IPackageStockpile{
 public:
-    using const_iterator = std::list<Package>::const_iterator;
+    using const_iterator = PackageRingIterator;
 
     virtual ~IPackageStockpile() = default;
     virtual std::size_t size() const = 0;
     virtual bool empty() const = 0;
     virtual void push(Package&& package) = 0;
+    // Liczba wszystkich przyjetych polproduktow - wieksza od size(), gdy czesc z nich nie jest przechowywana
+    virtual std::uint64_t received_count() const { return size(); }
+    // Liczba przechowywanych polproduktow - wieksza od size(), gdy czesc z nich jest poza pamiecia (spilled_ids())
+    virtual std::size_t stored_count() const { return size(); }
+    // ID polproduktow przeniesionych z pamieci (retention.hpp) - w kolejnosci przyjecia, przed polproduktami
+    // z iteratorow. Wazne do nastepnego push().
+    virtual PackageIdRange spilled_ids() const { return {}; }
 
     virtual const_iterator begin() const = 0;
     virtual const_iterator cbegin() const = 0;
@@ -38,23 +63,59 @@ public:
     virtual ~IPackageQueue() = default;
 };
 
+// Kolejka o rodzaju ustalonym w czasie kompilacji - metody nie sa wirtualne i rozwijaja sie w miejscu wywolania.
+template <PackageQueueType Type>
+class StaticPackageQueue {
+public:
+    using const_iterator = PackageRingIterator;
+
+    std::size_t size() const { return que_.size(); }
+    bool empty() const { return que_.empty(); }
+    void push(Package&& package) { que_.push_back(std::move(package)); }
+    Package pop() {
+        if constexpr (Type == PackageQueueType::FIFO) {
+            return que_.pop_front();
+        } else {
+            return que_.pop_back();
+        }
+    }
+    static constexpr PackageQueueType get_queue_type() { return Type; }
+
+    const_iterator begin() const { return que_.cbegin(); }
+    const_iterator end() const { return que_.cend(); }
+    const_iterator cbegin() const { return que_.cbegin(); }
+    const_iterator cend() const { return que_.cend(); }
+
+private:
+    PackageRingBuffer que_;
+};
+
+using FifoQueue = StaticPackageQueue<PackageQueueType::FIFO>;
+using LifoQueue = StaticPackageQueue<PackageQueueType::LIFO>;
+
+// Adapter kolejek statycznych do interfejsu wirtualnego - rodzaj wybierany w czasie dzialania.
+// Kod wydajnosciowy (Worker) pobiera raz get_static_queue() i dalej wola kolejke bezposrednio.
 class PackageQueue : public IPackageQueue{
 public:
-    explicit PackageQueue(PackageQueueType pqtype) : pqtype_(pqtype) {}
-    std::size_t size() const override { return que_.size(); }
-    bool empty() const override { return que_.empty(); }
-    void push(Package&& package) override { que_.emplace_back(std::move(package)); }
+    using static_queue_t = std::variant<FifoQueue, LifoQueue>;
 
-    const_iterator begin() const override { return que_.cbegin(); }
-    const_iterator end() const override { return que_.cend(); }
-    const_iterator cbegin() const override { return que_.cbegin(); }
-    const_iterator cend() const override { return que_.cend(); }
+    explicit PackageQueue(PackageQueueType pqtype);
+    std::size_t size() const override { return std::visit([](const auto& q) { return q.size(); }, que_); }
+    bool empty() const override { return std::visit([](const auto& q) { return q.empty(); }, que_); }
+    void push(Package&& package) override { std::visit([&package](auto& q) { q.push(std::move(package)); }, que_); }
 
-    Package pop() override;
+    const_iterator begin() const override { return cbegin(); }
+    const_iterator end() const override { return cend(); }
+    const_iterator cbegin() const override { return std::visit([](const auto& q) { return q.cbegin(); }, que_); }
+    const_iterator cend() const override { return std::visit([](const auto& q) { return q.cend(); }, que_); }
+
+    Package pop() override { return std::visit([](auto& q) { return q.pop(); }, que_); }
     PackageQueueType get_queue_type() const override { return pqtype_; }
 
+    static_queue_t& get_static_queue() { return que_; }
+
 private:
-    std::list<Package> que_;
+    static_queue_t que_;
     PackageQueueType pqtype_;
 };
 
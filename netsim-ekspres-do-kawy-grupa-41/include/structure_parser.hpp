@@ -0,0 +1,29 @@
+#ifndef NET_SIMULATION_STRUCTURE_PARSER_HPP
+#define NET_SIMULATION_STRUCTURE_PARSER_HPP
+
+#include "factory.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Blad w pliku ze struktura fabryki - komunikat zawiera numer linii (liczony od 1).
+class StructureParseError : public std::logic_error {
+public:
+    StructureParseError(std::size_t line, const std::string& message)
+            : std::logic_error("linia " + std::to_string(line) + ": " + message), line_(line) {}
+    std::size_t line() const { return line_; }
+
+private:
+    std::size_t line_;
+};
+
+// Wczytuje strukture w formacie load_factory_structure() bez kopiowania tekstu: linie i tokeny to std::string_view,
+// liczby czytane sa przez std::from_chars, a wezly i polaczenia dodawane do fabryki na biezaco, linia po linii.
+Factory parse_factory_structure(std::string_view text);
+
+// Jak wyzej, ale plik jest odwzorowywany w pamieci (mmap) zamiast wczytywania.
+Factory load_factory_structure_file(const std::string& path);
+
+#endif //NET_SIMULATION_STRUCTURE_PARSER_HPP
@@ -0,0 +1,50 @@
+#ifndef NET_SIMULATION_THREAD_POOL_HPP
+#define NET_SIMULATION_THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Staly zbior watkow wykonujacych petle rownolegle. Watek wywolujacy parallel_for() rowniez
+// bierze udzial w obliczeniach, wiec ThreadPool(1) dziala calkowicie sekwencyjnie.
+class ThreadPool {
+public:
+    using body_t = std::function<void(std::size_t begin, std::size_t end)>;
+
+    explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    std::size_t size() const { return threads_.size() + 1; }
+
+    // Dzieli [0, n) na fragmenty po co najwyzej `grain` elementow i wykonuje `body` dla kazdego z nich.
+    // Wraca dopiero po zakonczeniu wszystkich fragmentow; pierwszy zgloszony wyjatek jest przekazywany dalej.
+    void parallel_for(std::size_t n, const body_t& body, std::size_t grain = 0);
+
+private:
+    void worker_loop();
+    void run_chunks();
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable job_ready_;
+    std::condition_variable job_done_;
+
+    const body_t* body_ = nullptr;
+    std::size_t n_ = 0;
+    std::size_t grain_ = 1;
+    std::atomic<std::size_t> next_{0};
+    std::size_t generation_ = 0;
+    std::size_t busy_ = 0;
+    bool stopping_ = false;
+    std::exception_ptr error_;
+};
+
+#endif //NET_SIMULATION_THREAD_POOL_HPP
@@ -0,0 +1,41 @@
+#ifndef NET_SIMULATION_WORKER_STORE_HPP
+#define NET_SIMULATION_WORKER_STORE_HPP
+
+#include "nodes.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Stan robotnikow jako struktura tablic (po jednej na pole) - test "czy robotnik konczy w tej turze"
+// przeglada ciagle tablice liczb i jest liczony wektorowo dla wielu robotnikow naraz.
+// Polprodukty pozostaja w obiektach Worker; tu trzymane sa tylko ich ID.
+class WorkerStore {
+public:
+    static constexpr ElementID no_package = 0;
+
+    void resize(std::size_t size);
+    std::size_t size() const { return busy_.size(); }
+
+    // Odczytuje stan robotnika na pozycji `index`
+    void load(std::size_t index, const Worker& worker);
+    void clear_sending(std::size_t index) { sending_package_[index] = no_package; }
+
+    // finished[i] = 1, gdy robotnik i jest zajety i t - start >= pd - 1 (tak jak w Worker::do_work), wpp. 0.
+    // `finished` musi miec co najmniej size() elementow.
+    void mark_finished(Time t, std::uint8_t* finished) const;
+
+    const std::vector<Time>& get_start_times() const { return start_time_; }
+    const std::vector<TimeOffset>& get_processing_durations() const { return processing_duration_; }
+    const std::vector<std::uint8_t>& get_busy() const { return busy_; }
+    const std::vector<ElementID>& get_processing_package_ids() const { return processing_package_; }
+    const std::vector<ElementID>& get_sending_package_ids() const { return sending_package_; }
+
+private:
+    std::vector<Time> start_time_;
+    std::vector<TimeOffset> processing_duration_;
+    std::vector<std::uint8_t> busy_;
+    std::vector<ElementID> processing_package_;
+    std::vector<ElementID> sending_package_;
+};
+
+#endif //NET_SIMULATION_WORKER_STORE_HPP
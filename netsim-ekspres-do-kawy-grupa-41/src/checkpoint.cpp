@@ -0,0 +1,355 @@
+#include "checkpoint.hpp"
+
+#include "helpers.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr char checkpoint_magic[4] = {'N', 'S', 'C', 'P'};
+constexpr std::uint32_t checkpoint_version = 3;
+
+enum class GeneratorKind : std::uint8_t {
+    GLOBAL,
+    STREAM
+};
+
+enum class StockpileKind : std::uint8_t {
+    QUEUE,
+    RETAINING
+};
+
+class CheckpointWriter {
+public:
+    explicit CheckpointWriter(std::ostream& os) : os_(os) {}
+
+    template <class T>
+    void put(T value) { os_.write(reinterpret_cast<const char*>(&value), sizeof(T)); }
+
+    void put_package(const std::optional<Package>& package) {
+        if (!package) {
+            put<std::int32_t>(-1);
+            return;
+        }
+        put_stamped(*package);
+    }
+
+    void put_stock(IPackageStockpile::const_iterator begin, IPackageStockpile::const_iterator end) {
+        put<std::uint64_t>(static_cast<std::uint64_t>(std::distance(begin, end)));
+        for (auto it = begin; it != end; ++it) {
+            put_stamped(*it);
+        }
+    }
+
+//    ID i znaczniki z latency.hpp - zapisywane zawsze (bez pomiaru opoznien sa zerami), wiec format nie zalezy od flag kompilacji
+    void put_stamped(const Package& package) {
+        put<std::int32_t>(package.get_id());
+        put<std::int32_t>(package.get_birth_time());
+        put<std::int32_t>(package.get_origin());
+    }
+
+    void put_ids(const std::vector<std::int32_t>& ids) { put_ids(ids.data(), ids.size()); }
+
+    void put_ids(const std::int32_t* ids, std::size_t count) {
+        put<std::uint64_t>(count);
+        os_.write(reinterpret_cast<const char*>(ids), static_cast<std::streamsize>(count * sizeof(std::int32_t)));
+    }
+
+    void put_string(const std::string& text) {
+        put<std::uint64_t>(text.size());
+        os_.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+
+//    Polityka przechowywania (retention.hpp) razem z ID przeniesionymi do pliku; inne magazyny - jako kolejka FIFO
+    void put_stockpile(const Storehouse& storehouse) {
+        auto retaining = dynamic_cast<const RetainingStockpile*>(storehouse.get_stockpile());
+        if (retaining == nullptr) {
+            put(StockpileKind::QUEUE);
+            return;
+        }
+        put(StockpileKind::RETAINING);
+        put(retaining->get_policy());
+        put<std::uint64_t>(retaining->get_keep());
+        put<std::uint64_t>(retaining->received_count());
+        put_string(retaining->get_spill_path());
+        const PackageIdRange spilled = retaining->spilled_ids();
+        put_ids(spilled.begin(), spilled.size());
+    }
+
+    void put_stream(const RandomStream& stream) {
+        put<std::uint64_t>(stream.get_seed());
+        put<std::uint64_t>(stream.get_stream());
+        put<std::uint64_t>(stream.get_position());
+    }
+
+    void put_generator(const ProbabilityGenerator& generator) {
+        if (auto stream = generator.target<RandomStream>()) {
+            put(GeneratorKind::STREAM);
+            put_stream(*stream);
+            return;
+        }
+        auto function = generator.target<double (*)()>();
+        if (function and *function == default_probability_generator) {
+            put(GeneratorKind::GLOBAL);
+            return;
+        }
+        throw std::logic_error("Nie mozna zapisac stanu generatora liczb losowych.");
+    }
+
+    void put_receivers(const ReceiverPreferences& preferences) {
+        put<std::uint64_t>(preferences.get_preferences().size());
+        for (const auto& pair: preferences.get_preferences()) {
+            put(pair.first->get_receiver_type());
+            put<std::int32_t>(pair.first->get_id());
+            put<double>(preferences.get_weight(pair.first));
+        }
+    }
+
+private:
+    std::ostream& os_;
+};
+
+class CheckpointReader {
+public:
+    explicit CheckpointReader(std::istream& is) : is_(is) {}
+
+    template <class T>
+    T get() {
+        T value;
+        read(&value, sizeof(T));
+        return value;
+    }
+
+    std::optional<Package> get_package(SimulationContext& context) {
+        auto id = get<std::int32_t>();
+        return id < 0 ? std::nullopt : std::optional<Package>(get_stamped(id, context));
+    }
+
+    std::vector<Package> get_stock(SimulationContext& context) {
+        std::vector<Package> stock;
+        auto count = get<std::uint64_t>();
+        for (std::uint64_t i = 0; i < count; ++i) {
+            stock.push_back(get_stamped(get<std::int32_t>(), context));
+        }
+        return stock;
+    }
+
+    Package get_stamped(ElementID id, SimulationContext& context) {
+        Package package(id, context);
+        auto birth_time = get<std::int32_t>();
+        package.stamp_birth(birth_time, get<std::int32_t>());
+        return package;
+    }
+
+    std::vector<std::int32_t> get_ids() { return get_sequence<std::vector<std::int32_t>>(); }
+
+    std::string get_string() { return get_sequence<std::string>(); }
+
+    Storehouse get_storehouse(ElementID id, SimulationContext& context) {
+        if (get<StockpileKind>() == StockpileKind::QUEUE) {
+            Storehouse storehouse(id);
+            for (auto& package: get_stock(context)) {
+                storehouse.restore_stock(std::move(package));
+            }
+            return storehouse;
+        }
+        auto policy = get<RetentionPolicy>();
+        auto keep = get<std::uint64_t>();
+        auto received = get<std::uint64_t>();
+        get_string();
+        auto spilled = get_ids();
+        if (policy != RetentionPolicy::SPILL and !spilled.empty()) {
+            throw std::runtime_error("Uszkodzony punkt kontrolny: polprodukty w pliku bez polityki SPILL.");
+        }
+//        Nazwany plik SPILL moze nadal nalezec do magazynu, z ktorego zapisano punkt kontrolny (i byc przez niego
+//        odwzorowany w pamieci) - odtworzone ID ida do nowego pliku tymczasowego
+        auto stockpile = std::make_unique<RetainingStockpile>(policy, keep);
+        if (!spilled.empty()) {
+            stockpile->restore_spilled_ids(spilled);
+        }
+        for (auto& package: get_stock(context)) {
+            stockpile->push(std::move(package));
+        }
+        stockpile->restore_received_count(received);
+        return Storehouse(id, std::move(stockpile));
+    }
+
+    RandomStream get_stream() {
+        auto seed = get<std::uint64_t>();
+        auto stream_id = get<std::uint64_t>();
+        RandomStream stream(seed, stream_id);
+        stream.seek(get<std::uint64_t>());
+        return stream;
+    }
+
+    ProbabilityGenerator get_generator() {
+        switch (get<GeneratorKind>()) {
+            case GeneratorKind::GLOBAL:
+                return default_probability_generator;
+            case GeneratorKind::STREAM:
+                return get_stream();
+        }
+        throw std::runtime_error("Uszkodzony punkt kontrolny: nieznany generator.");
+    }
+
+    void get_receivers(Factory& factory, ReceiverPreferences& preferences) {
+        auto count = get<std::uint64_t>();
+        for (std::uint64_t i = 0; i < count; ++i) {
+            auto type = get<ReceiverType>();
+            auto id = get<std::int32_t>();
+            auto weight = get<double>();
+            IPackageReceiver* receiver = nullptr;
+            if (type == ReceiverType::WORKER and factory.find_worker_by_id(id) != factory.worker_end()) {
+                receiver = &*factory.find_worker_by_id(id);
+            } else if (type == ReceiverType::STOREHOUSE and factory.find_storehouse_by_id(id) != factory.storehouse_end()) {
+                receiver = &*factory.find_storehouse_by_id(id);
+            }
+            if (receiver == nullptr) {
+                throw std::runtime_error("Uszkodzony punkt kontrolny: nieznany odbiorca.");
+            }
+            preferences.add_receiver(receiver, weight);
+        }
+    }
+
+private:
+//    Rozmiar z pliku nie jest wiarygodny - zawartosc przybywa porcjami, wiec uszkodzony rozmiar konczy sie
+//    bledem odczytu zamiast ogromnej alokacji
+    template <class Sequence>
+    Sequence get_sequence() {
+        constexpr std::uint64_t chunk = 64 * 1024;
+        const auto count = get<std::uint64_t>();
+        Sequence values;
+        while (values.size() < count) {
+            const auto n = static_cast<std::size_t>(std::min(count - values.size(), chunk));
+            values.resize(values.size() + n);
+            read(&values[values.size() - n], n * sizeof(values[0]));
+        }
+        return values;
+    }
+
+    void read(void* data, std::size_t size) {
+        if (!is_.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+            throw std::runtime_error("Uszkodzony punkt kontrolny: nieoczekiwany koniec danych.");
+        }
+    }
+
+    std::istream& is_;
+};
+
+}
+
+void save_checkpoint(const Factory& factory, Time turn, std::ostream& os) {
+    CheckpointWriter writer(os);
+    os.write(checkpoint_magic, sizeof(checkpoint_magic));
+    writer.put(checkpoint_version);
+    writer.put<std::int32_t>(turn);
+
+    const IdAllocator& allocator = factory.get_context().id_allocator();
+    writer.put<std::int32_t>(allocator.get_next_fresh_id());
+    writer.put_ids(allocator.get_freed_ids());
+    writer.put_stream(rng);
+
+//    Najpierw wszystkie wezly, potem polaczenia - przy odczycie odbiorcy musza juz istniec
+    writer.put<std::uint64_t>(static_cast<std::uint64_t>(std::distance(factory.ramp_cbegin(), factory.ramp_cend())));
+    for (auto it = factory.ramp_cbegin(); it != factory.ramp_cend(); ++it) {
+        writer.put<std::int32_t>(it->get_id());
+        writer.put<std::int32_t>(it->get_delivery_interval());
+        writer.put_package(it->get_sending_buffer());
+        writer.put_generator(it->receiver_preferences_.get_generator());
+    }
+    writer.put<std::uint64_t>(static_cast<std::uint64_t>(std::distance(factory.worker_cbegin(), factory.worker_cend())));
+    for (auto it = factory.worker_cbegin(); it != factory.worker_cend(); ++it) {
+        writer.put<std::int32_t>(it->get_id());
+        writer.put<std::int32_t>(it->get_processing_duration());
+        writer.put(it->get_queue()->get_queue_type());
+        writer.put_stock(it->cbegin(), it->cend());
+        writer.put_package(it->get_processing_buffer());
+        writer.put<std::int32_t>(it->get_package_processing_start_time());
+        writer.put_package(it->get_sending_buffer());
+        writer.put_generator(it->receiver_preferences_.get_generator());
+    }
+    writer.put<std::uint64_t>(static_cast<std::uint64_t>(std::distance(factory.storehouse_cbegin(), factory.storehouse_cend())));
+    for (auto it = factory.storehouse_cbegin(); it != factory.storehouse_cend(); ++it) {
+        writer.put<std::int32_t>(it->get_id());
+        writer.put_stockpile(*it);
+        writer.put_stock(it->cbegin(), it->cend());
+    }
+
+    for (auto it = factory.ramp_cbegin(); it != factory.ramp_cend(); ++it) {
+        writer.put_receivers(it->receiver_preferences_);
+    }
+    for (auto it = factory.worker_cbegin(); it != factory.worker_cend(); ++it) {
+        writer.put_receivers(it->receiver_preferences_);
+    }
+}
+
+Checkpoint load_checkpoint(std::istream& is) {
+    CheckpointReader reader(is);
+    char magic[sizeof(checkpoint_magic)];
+    for (auto& c: magic) {
+        c = reader.get<char>();
+    }
+    if (!std::equal(std::begin(magic), std::end(magic), std::begin(checkpoint_magic)) or reader.get<std::uint32_t>() != checkpoint_version) {
+        throw std::runtime_error("Niezgodny format punktu kontrolnego.");
+    }
+
+    Checkpoint checkpoint{Factory(), reader.get<std::int32_t>()};
+    Factory& factory = checkpoint.factory;
+    SimulationContext& context = factory.get_context();
+
+    auto next_fresh_id = reader.get<std::int32_t>();
+    auto freed_ids = reader.get_ids();
+    rng = reader.get_stream();
+
+    auto ramps = reader.get<std::uint64_t>();
+    for (std::uint64_t i = 0; i < ramps; ++i) {
+        auto id = reader.get<std::int32_t>();
+        auto delivery_interval = reader.get<std::int32_t>();
+        Ramp ramp(id, delivery_interval);
+        if (auto package = reader.get_package(context)) {
+            ramp.restore_sending_buffer(std::move(*package));
+        }
+        ramp.receiver_preferences_.set_generator(reader.get_generator());
+        factory.add_ramp(std::move(ramp));
+    }
+    auto workers = reader.get<std::uint64_t>();
+    for (std::uint64_t i = 0; i < workers; ++i) {
+        auto id = reader.get<std::int32_t>();
+        auto processing_duration = reader.get<std::int32_t>();
+        auto queue_type = reader.get<PackageQueueType>();
+        Worker worker(id, processing_duration, std::make_unique<PackageQueue>(queue_type));
+        for (auto& package: reader.get_stock(context)) {
+            worker.receive_package(std::move(package));
+        }
+        auto processing = reader.get_package(context);
+        auto start_time = reader.get<std::int32_t>();
+        worker.restore_processing_buffer(std::move(processing), start_time);
+        if (auto package = reader.get_package(context)) {
+            worker.restore_sending_buffer(std::move(*package));
+        }
+        worker.receiver_preferences_.set_generator(reader.get_generator());
+        factory.add_worker(std::move(worker));
+    }
+    auto storehouses = reader.get<std::uint64_t>();
+    for (std::uint64_t i = 0; i < storehouses; ++i) {
+        auto id = reader.get<std::int32_t>();
+        factory.add_storehouse(reader.get_storehouse(id, context));
+    }
+
+    for (auto it = factory.ramp_begin(); it != factory.ramp_end(); ++it) {
+        reader.get_receivers(factory, it->receiver_preferences_);
+    }
+    for (auto it = factory.worker_begin(); it != factory.worker_end(); ++it) {
+        reader.get_receivers(factory, it->receiver_preferences_);
+    }
+
+    context.id_allocator().restore(next_fresh_id, freed_ids);
+    return checkpoint;
+}
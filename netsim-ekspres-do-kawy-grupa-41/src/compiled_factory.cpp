@@ -0,0 +1,130 @@
+#include "compiled_factory.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+CompiledFactory::CompiledFactory(Factory& factory)
+        : factory_(&factory), topology_version_(factory.get_topology_version()), link_version_(factory.get_link_version()) {
+    if (!factory.is_consistent()) {
+        throw std::logic_error("Siec nie jest spojna.");
+    }
+    std::unordered_map<const IPackageReceiver*, std::uint32_t> receiver_index;
+    for (auto it = factory.ramp_begin(); it != factory.ramp_end(); ++it) {
+        ramps_.push_back(&*it);
+    }
+    for (auto it = factory.worker_begin(); it != factory.worker_end(); ++it) {
+        receiver_index.emplace(&*it, static_cast<std::uint32_t>(workers_.size()));
+        workers_.push_back(&*it);
+    }
+    for (auto it = factory.storehouse_begin(); it != factory.storehouse_end(); ++it) {
+        receiver_index.emplace(&*it, static_cast<std::uint32_t>(workers_.size() + storehouses_.size()));
+        storehouses_.push_back(&*it);
+    }
+
+    edge_offsets_.reserve(ramps_.size() + workers_.size() + 1);
+    edge_offsets_.push_back(0);
+    auto add_edges = [&](const PackageSender& sender) {
+        const auto& table = sender.receiver_preferences_;
+        const auto& receivers = table.get_receivers();
+        for (std::size_t i = 0; i < receivers.size(); ++i) {
+            auto found = receiver_index.find(receivers[i]);
+            if (found == receiver_index.end()) {
+                throw std::logic_error("Odbiorca spoza fabryki.");
+            }
+            edge_targets_.push_back(found->second);
+            alias_probability_.push_back(table.get_alias_probabilities()[i]);
+            alias_.push_back(static_cast<std::uint32_t>(table.get_aliases()[i]));
+        }
+        edge_offsets_.push_back(static_cast<std::uint32_t>(edge_targets_.size()));
+        table_versions_.push_back(table.get_rebuild_count());
+    };
+    for (auto ramp: ramps_) {
+        add_edges(*ramp);
+    }
+    for (auto worker: workers_) {
+        add_edges(*worker);
+    }
+
+    worker_store_.resize(workers_.size());
+    finished_.resize(workers_.size());
+    sync_workers();
+}
+
+void CompiledFactory::sync_workers() {
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        worker_store_.load(i, *workers_[i]);
+    }
+}
+
+bool CompiledFactory::is_stale() const {
+    if (factory_->get_topology_version() != topology_version_ or factory_->get_link_version() != link_version_) {
+        return true;
+    }
+//    Wezly sie nie zmienily, wiec wskazniki sa wazne - pozostaje sprawdzic przebudowy tablic aliasow (zmiany wag)
+    for (std::size_t i = 0; i < ramps_.size(); ++i) {
+        if (ramps_[i]->receiver_preferences_.get_rebuild_count() != table_versions_[i]) {
+            return true;
+        }
+    }
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        if (workers_[i]->receiver_preferences_.get_rebuild_count() != table_versions_[ramps_.size() + i]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void CompiledFactory::do_deliveries(Time t) {
+    factory_->get_context().set_turn(t);
+    for (auto ramp: ramps_) {
+        ramp->deliver_goods(t);
+    }
+}
+
+// Ten sam wybor co ReceiverTable::pick() dla liczby z generatora nadawcy; odbiorca wywolywany bez wirtualnego
+// przekazania, bo jego typ wynika z indeksu.
+void CompiledFactory::pass_from(PackageSender& sender, std::size_t sender_index) {
+    if (!sender.get_sending_buffer()) {
+        return;
+    }
+    const std::uint32_t first = edge_offsets_[sender_index];
+    const std::size_t count = edge_offsets_[sender_index + 1] - first;
+    const double num = sender.receiver_preferences_.get_generator()();
+    if (!(0 <= num and num <= 1) or count == 0) {
+        throw std::exception();
+    }
+    const double scaled = num * static_cast<double>(count);
+    const std::size_t i = std::min(static_cast<std::size_t>(scaled), count - 1);
+    const std::size_t edge = first + (scaled - static_cast<double>(i) < alias_probability_[first + i] ? i : alias_[first + i]);
+    const std::uint32_t target = edge_targets_[edge];
+    if (target < workers_.size()) {
+        workers_[target]->Worker::receive_package(sender.release_sending_buffer());
+    } else {
+        storehouses_[target - workers_.size()]->Storehouse::receive_package(sender.release_sending_buffer());
+    }
+}
+
+void CompiledFactory::do_package_passing() {
+    for (std::size_t i = 0; i < ramps_.size(); ++i) {
+        pass_from(*ramps_[i], i);
+    }
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        pass_from(*workers_[i], ramps_.size() + i);
+        worker_store_.clear_sending(i);
+    }
+}
+
+// Zajety robotnik, ktory w tej turze nie konczy, i wolny bez polproduktow w kolejce nic by nie zrobili -
+// Worker::do_work wywolywane jest tylko dla pozostalych (chyba ze zbierane sa metryki kazdej tury).
+void CompiledFactory::do_work(Time t) {
+    worker_store_.mark_finished(t, finished_.data());
+    const auto& busy = worker_store_.get_busy();
+    for (std::size_t i = 0; i < workers_.size(); ++i) {
+        Worker& worker = *workers_[i];
+        if (node_metrics_enabled or (busy[i] ? finished_[i] != 0 : worker.has_queued_packages())) {
+            worker.do_work(t);
+            worker_store_.load(i, worker);
+        }
+    }
+}
@@ -0,0 +1,273 @@
+#include "consistency_tracker.hpp"
+
+#include <algorithm>
+
+namespace {
+
+TrackedKind tracked_kind(SenderType type) {
+    return type == SenderType::RAMP ? TrackedKind::RAMP : TrackedKind::WORKER;
+}
+
+TrackedKind tracked_kind(ReceiverType type) {
+    return type == ReceiverType::STOREHOUSE ? TrackedKind::STOREHOUSE : TrackedKind::WORKER;
+}
+
+}
+
+// Wezly polaczone bezposrednio z magazynem (z rampa) nie straca tego stanu przy zmianach gdzie indziej -
+// na nich zatrzymuje sie przeliczanie.
+bool ConsistencyTracker::sends_to_storehouse(const Node& node) {
+    return std::any_of(node.successors.begin(), node.successors.end(), [](const Node* n) { return is_reach_source(*n); });
+}
+
+bool ConsistencyTracker::receives_from_ramp(const Node& node) {
+    return std::any_of(node.predecessors.begin(), node.predecessors.end(), [](const Node* n) { return is_feed_source(*n); });
+}
+
+ConsistencyTracker::Node& ConsistencyTracker::node(TrackedKind kind, ElementID id) {
+    auto [it, inserted] = nodes_.try_emplace(key(kind, id));
+    if (inserted) {
+        it->second.kind = kind;
+        it->second.id = id;
+    }
+    return it->second;
+}
+
+ConsistencyTracker::Node* ConsistencyTracker::find_node(TrackedKind kind, ElementID id) {
+    auto it = nodes_.find(key(kind, id));
+    return it == nodes_.end() ? nullptr : &it->second;
+}
+
+ConsistencyTracker::Node* ConsistencyTracker::find_receiver(ReceiverTable::ReceiverKey key, const IPackageReceiver* receiver) {
+    Node* found = find_node(tracked_kind(key.type), key.id);
+    return found != nullptr and found->present and found->receiver == receiver ? found : nullptr;
+}
+
+void ConsistencyTracker::erase_if_unused(Node& node) {
+    if (!node.present and node.successors.empty() and node.predecessors.empty() and node.outside_links == 0) {
+        nodes_.erase(key(node.kind, node.id));
+    }
+}
+
+void ConsistencyTracker::add_node(TrackedKind kind, ElementID id, const IPackageReceiver* receiver) {
+    Node& added = node(kind, id);
+//    Przy powtorzonych ID polaczenia roznych wezlow sa nierozroznialne - dopoki powtorzenie istnieje, werdykt daje
+//    pelne sprawdzenie
+    if (added.present) {
+        ++added.copies;
+        ++duplicated_ids_;
+        return;
+    }
+    added.receiver = receiver;
+    update(added, [](Node& n) { n.present = true; });
+    if (kind == TrackedKind::STOREHOUSE and !added.reaches_storehouse) {
+        update(added, [](Node& n) { n.reaches_storehouse = true; });
+        spread_reach(added);
+    }
+    if (kind == TrackedKind::RAMP and !added.fed_by_ramp) {
+        update(added, [](Node& n) { n.fed_by_ramp = true; });
+        spread_feed(added);
+    }
+}
+
+void ConsistencyTracker::remove_node(TrackedKind kind, ElementID id) {
+    Node* removed = find_node(kind, id);
+    if (removed == nullptr or !removed->present) {
+        return;
+    }
+    if (removed->copies > 0) {
+        --removed->copies;
+        --duplicated_ids_;
+        return;
+    }
+    while (!removed->successors.empty()) {
+        Node& receiver = *removed->successors.back();
+        remove_link(*removed, receiver);
+    }
+    outside_links_ -= removed->outside_links;
+    removed->outside_links = 0;
+//    Pozostale polaczenia przychodzace prowadza odtad poza fabryke
+    while (!removed->predecessors.empty()) {
+        Node& sender = *removed->predecessors.back();
+        remove_link(sender, *removed);
+        ++sender.outside_links;
+        ++outside_links_;
+    }
+    update(*removed, [](Node& n) { n.present = false; });
+    removed->receiver = nullptr;
+    if (kind == TrackedKind::STOREHOUSE) {
+        recompute_reach(*removed);
+    }
+    if (kind == TrackedKind::RAMP) {
+        recompute_feed(*removed);
+    }
+    erase_if_unused(*removed);
+}
+
+void ConsistencyTracker::clear() {
+    nodes_.clear();
+    offending_nodes_ = 0;
+    outside_links_ = 0;
+    duplicated_ids_ = 0;
+    ++link_changes_;
+}
+
+void ConsistencyTracker::link_added(SenderType sender_type, ElementID sender_id, ReceiverTable::ReceiverKey key,
+                                    const IPackageReceiver* receiver) {
+    ++link_changes_;
+    Node& sender = node(tracked_kind(sender_type), sender_id);
+    Node* target = find_receiver(key, receiver);
+    if (target == nullptr) {
+        ++sender.outside_links;
+        ++outside_links_;
+        return;
+    }
+    sender.successors.push_back(target);
+    target->predecessors.push_back(&sender);
+    if (target->reaches_storehouse and !sender.reaches_storehouse) {
+        update(sender, [](Node& n) { n.reaches_storehouse = true; });
+        spread_reach(sender);
+    }
+    if (sender.fed_by_ramp and !target->fed_by_ramp) {
+        update(*target, [](Node& n) { n.fed_by_ramp = true; });
+        spread_feed(*target);
+    }
+}
+
+void ConsistencyTracker::link_removed(SenderType sender_type, ElementID sender_id, ReceiverTable::ReceiverKey key,
+                                      const IPackageReceiver* receiver) {
+    ++link_changes_;
+    Node* sender = find_node(tracked_kind(sender_type), sender_id);
+    if (sender == nullptr) {
+        return;
+    }
+    Node* target = find_receiver(key, receiver);
+    if (target != nullptr) {
+        remove_link(*sender, *target);
+    } else if (sender->outside_links > 0) {
+        --sender->outside_links;
+        --outside_links_;
+    }
+    erase_if_unused(*sender);
+}
+
+std::vector<std::pair<TrackedKind, ElementID>> ConsistencyTracker::get_predecessors(TrackedKind kind, ElementID id) const {
+    std::vector<std::pair<TrackedKind, ElementID>> predecessors;
+    auto it = nodes_.find(key(kind, id));
+    if (it != nodes_.end()) {
+        for (const Node* sender: it->second.predecessors) {
+            predecessors.emplace_back(sender->kind, sender->id);
+        }
+    }
+    return predecessors;
+}
+
+void ConsistencyTracker::remove_link(Node& sender, Node& receiver) {
+    auto drop = [](std::vector<Node*>& nodes, Node* n) {
+        auto it = std::find(nodes.begin(), nodes.end(), n);
+        if (it != nodes.end()) {
+            *it = nodes.back();
+            nodes.pop_back();
+        }
+    };
+    drop(sender.successors, &receiver);
+    drop(receiver.predecessors, &sender);
+    if (sender.reaches_storehouse and receiver.reaches_storehouse) {
+        recompute_reach(sender);
+    }
+    if (sender.fed_by_ramp and receiver.fed_by_ramp) {
+        recompute_feed(receiver);
+    }
+}
+
+void ConsistencyTracker::spread_reach(Node& start) {
+    stack_.assign(1, &start);
+    while (!stack_.empty()) {
+        Node* n = stack_.back();
+        stack_.pop_back();
+        for (Node* sender: n->predecessors) {
+            if (!sender->reaches_storehouse) {
+                update(*sender, [](Node& s) { s.reaches_storehouse = true; });
+                stack_.push_back(sender);
+            }
+        }
+    }
+}
+
+void ConsistencyTracker::spread_feed(Node& start) {
+    stack_.assign(1, &start);
+    while (!stack_.empty()) {
+        Node* n = stack_.back();
+        stack_.pop_back();
+        for (Node* receiver: n->successors) {
+            if (!receiver->fed_by_ramp) {
+                update(*receiver, [](Node& r) { r.fed_by_ramp = true; });
+                stack_.push_back(receiver);
+            }
+        }
+    }
+}
+
+// Wezel `start` mogl stracic droge do magazynu. Zmiana dotyczy tylko jego poprzednikow, ktore do magazynu dochodzily
+// (bez polaczonych z nim bezposrednio): zerujemy ich stan i odbudowujemy go od tych, ktore maja nastepnika
+// dochodzacego do magazynu spoza tego obszaru.
+void ConsistencyTracker::recompute_reach(Node& start) {
+    if (!start.reaches_storehouse or sends_to_storehouse(start)) {
+        return;
+    }
+    ++epoch_;
+    affected_.clear();
+    stack_.assign(1, &start);
+    start.mark = epoch_;
+    while (!stack_.empty()) {
+        Node* n = stack_.back();
+        stack_.pop_back();
+        affected_.push_back(n);
+        for (Node* sender: n->predecessors) {
+            if (sender->reaches_storehouse and sender->mark != epoch_ and !sends_to_storehouse(*sender)) {
+                sender->mark = epoch_;
+                stack_.push_back(sender);
+            }
+        }
+    }
+    for (Node* n: affected_) {
+        update(*n, [](Node& a) { a.reaches_storehouse = false; });
+    }
+    for (Node* n: affected_) {
+        if (!n->reaches_storehouse and std::any_of(n->successors.begin(), n->successors.end(), [](const Node* s) { return s->reaches_storehouse; })) {
+            update(*n, [](Node& a) { a.reaches_storehouse = true; });
+            spread_reach(*n);
+        }
+    }
+}
+
+// Lustrzane odbicie recompute_reach: `start` mogl stracic zasilanie z rampy, przeliczamy jego nastepnikow.
+void ConsistencyTracker::recompute_feed(Node& start) {
+    if (!start.fed_by_ramp or receives_from_ramp(start)) {
+        return;
+    }
+    ++epoch_;
+    affected_.clear();
+    stack_.assign(1, &start);
+    start.mark = epoch_;
+    while (!stack_.empty()) {
+        Node* n = stack_.back();
+        stack_.pop_back();
+        affected_.push_back(n);
+        for (Node* receiver: n->successors) {
+            if (receiver->fed_by_ramp and receiver->mark != epoch_ and !receives_from_ramp(*receiver)) {
+                receiver->mark = epoch_;
+                stack_.push_back(receiver);
+            }
+        }
+    }
+    for (Node* n: affected_) {
+        update(*n, [](Node& a) { a.fed_by_ramp = false; });
+    }
+    for (Node* n: affected_) {
+        if (!n->fed_by_ramp and std::any_of(n->predecessors.begin(), n->predecessors.end(), [](const Node* p) { return p->fed_by_ramp; })) {
+            update(*n, [](Node& a) { a.fed_by_ramp = true; });
+            spread_feed(*n);
+        }
+    }
+}
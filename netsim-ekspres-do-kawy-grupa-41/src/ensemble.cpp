@@ -0,0 +1,81 @@
+#include "ensemble.hpp"
+
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+struct NodeSample {
+    ElementType type;
+    ElementID id;
+    double value;
+};
+
+std::vector<NodeSample> run_replica(const std::string& structure, TimeOffset turns, std::uint64_t base_seed, std::size_t replica) {
+    std::seed_seq seed_sequence{static_cast<std::uint32_t>(base_seed), static_cast<std::uint32_t>(base_seed >> 32),
+                                static_cast<std::uint32_t>(replica), static_cast<std::uint32_t>(static_cast<std::uint64_t>(replica) >> 32)};
+    std::array<std::uint32_t, 2> seed{};
+    seed_sequence.generate(seed.begin(), seed.end());
+
+    std::istringstream iss(structure);
+    Factory factory = load_factory_structure(iss);
+    factory.seed_streams((static_cast<std::uint64_t>(seed[0]) << 32) | seed[1]);
+
+    simulate(factory, turns, [](Factory&, Time) {});
+
+    std::vector<NodeSample> samples;
+    for (auto it = factory.worker_cbegin(); it != factory.worker_cend(); ++it) {
+        double value = static_cast<double>(it->get_queue()->size())
+                + (it->get_processing_buffer() ? 1 : 0) + (it->get_sending_buffer() ? 1 : 0);
+        samples.push_back({ElementType::WORKER, it->get_id(), value});
+    }
+    for (auto it = factory.storehouse_cbegin(); it != factory.storehouse_cend(); ++it) {
+        samples.push_back({ElementType::STOREHOUSE, it->get_id(), static_cast<double>(it->get_received_count())});
+    }
+    std::stable_sort(samples.begin(), samples.end(), [](const NodeSample& a, const NodeSample& b) {
+        return a.type != b.type ? a.type < b.type : a.id < b.id;
+    });
+    return samples;
+}
+
+}
+
+std::vector<NodeStatistics> run_ensemble(const std::string& structure, const EnsembleOptions& options, ThreadPool& pool) {
+    if (options.replicas == 0) {
+        throw std::invalid_argument("Liczba replik musi byc dodatnia.");
+    }
+
+    std::vector<std::vector<NodeSample>> results(options.replicas);
+    pool.parallel_for(options.replicas, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t r = begin; r < end; ++r) {
+            results[r] = run_replica(structure, options.turns, options.base_seed, r);
+        }
+    }, 1);
+
+//    Agregacja w kolejnosci replik (algorytm Welforda) - wynik nie zalezy od kolejnosci wykonania
+    const auto& first = results.front();
+    std::vector<double> mean(first.size(), 0.0);
+    std::vector<double> m2(first.size(), 0.0);
+    for (std::size_t r = 0; r < results.size(); ++r) {
+        for (std::size_t i = 0; i < first.size(); ++i) {
+            double delta = results[r][i].value - mean[i];
+            mean[i] += delta / static_cast<double>(r + 1);
+            m2[i] += delta * (results[r][i].value - mean[i]);
+        }
+    }
+
+    const auto n = static_cast<double>(results.size());
+    std::vector<NodeStatistics> statistics;
+    for (std::size_t i = 0; i < first.size(); ++i) {
+        double variance = results.size() > 1 ? m2[i] / (n - 1) : 0.0;
+        double half_width = options.confidence_z * std::sqrt(variance / n);
+        statistics.push_back({first[i].type, first[i].id, mean[i], variance, mean[i] - half_width, mean[i] + half_width});
+    }
+    return statistics;
+}
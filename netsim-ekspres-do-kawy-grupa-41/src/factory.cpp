@@ -3,76 +3,312 @@
 //
 
 #include "factory.hpp"
+#include "structure_parser.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <iterator>
+#include <limits>
 #include <unordered_map>
 #include <iostream>
 
-bool has_reachable_storehouse(const PackageSender* sender, std::map<const PackageSender*, NodeColor>& node_colors) {
-    if (node_colors[sender] == NodeColor::VERIFIED){
-        return true;
+namespace {
+
+// Najkrotszy zapis wagi, z ktorego from_chars odtwarza dokladnie te sama liczbe
+std::string weight_to_string(double weight) {
+    char digits[32];
+    auto result = std::to_chars(std::begin(digits), std::end(digits), weight);
+    return std::string(digits, result.ptr);
+}
+
+}
+
+bool Factory::is_consistent() const {
+    if (tracker_->is_exact()) {
+        return tracker_->is_consistent();
     }
-    node_colors[sender] = NodeColor::VISITED;
-    if (sender->receiver_preferences_.cbegin() == sender->receiver_preferences_.cend()){
-        throw std::logic_error("No receivers found");
+    try {
+        return check_consistency().consistent;
+    } catch (const std::logic_error&) {
+        return false;
+    }
+}
+
+// Graf nadawcow w postaci CSR: rampy maja indeksy [0, R), robotnicy [R, R + W).
+// Krawedzie do magazynow nie sa zapisywane - wystarczy znacznik przy nadawcy.
+ConsistencyReport Factory::check_consistency() const {
+    const std::size_t ramp_count = ramps_.size();
+    const std::size_t node_count = ramp_count + workers_.size();
+    std::vector<const Worker*> workers;
+    workers.reserve(workers_.size());
+
+//    ID robotnika -> indeks wezla: tablica, gdy ID sa gesto upakowane, w przeciwnym razie tablica haszujaca
+    ElementID min_worker_id = 0;
+    ElementID max_worker_id = 0;
+    for (const auto& worker: workers_) {
+        workers.push_back(&worker);
+        min_worker_id = std::min(min_worker_id, worker.get_id());
+        max_worker_id = std::max(max_worker_id, worker.get_id());
+    }
+    const bool dense_ids = min_worker_id >= 0 and static_cast<std::size_t>(max_worker_id) <= 4 * workers.size() + 1024;
+    constexpr auto no_index = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> flat_index(dense_ids ? static_cast<std::size_t>(max_worker_id) + 1 : 0, no_index);
+    std::unordered_map<ElementID, std::uint32_t> hashed_index;
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        auto index = static_cast<std::uint32_t>(ramp_count + i);
+        if (dense_ids) {
+            flat_index[static_cast<std::size_t>(workers[i]->get_id())] = index;
+        } else {
+            hashed_index.emplace(workers[i]->get_id(), index);
+        }
     }
-    bool does_sender_have_unique_receiver = false;
-    for(const auto& pair: sender->receiver_preferences_){
-        IPackageReceiver* receiver_p = pair.first;
-        if (receiver_p->get_receiver_type() == ReceiverType::STOREHOUSE) {
-            does_sender_have_unique_receiver = true;
+    auto worker_index = [&](const IPackageReceiver* receiver, ElementID id) {
+        std::uint32_t index = no_index;
+        if (dense_ids) {
+            index = id >= 0 and static_cast<std::size_t>(id) < flat_index.size() ? flat_index[static_cast<std::size_t>(id)] : no_index;
+        } else if (auto it = hashed_index.find(id); it != hashed_index.end()) {
+            index = it->second;
         }
-        else {
-            auto worker_ptr = dynamic_cast<Worker*>(receiver_p);
-            auto sendrecv_ptr = dynamic_cast<PackageSender*>(worker_ptr);
-            if (sendrecv_ptr != sender) {
-                does_sender_have_unique_receiver = true;
+//        Indeks po ID wskazuje jeden z wezlow o tym ID - przy powtorzeniach szukamy wlasciwego po adresie
+        if (index != no_index and workers[index - ramp_count] != receiver) {
+            auto found = std::find(workers.begin(), workers.end(), receiver);
+            index = found == workers.end() ? no_index : static_cast<std::uint32_t>(ramp_count + (found - workers.begin()));
+        }
+        if (index == no_index) {
+            throw std::logic_error("Odbiorca spoza fabryki.");
+        }
+        return index;
+    };
+
+    auto is_own_storehouse = [&](const IPackageReceiver* receiver, ElementID id) {
+        auto found = storehouses_.find_by_id(id);
+        if (found != storehouses_.cend() and &*found == receiver) {
+            return true;
+        }
+        return std::any_of(storehouses_.cbegin(), storehouses_.cend(), [=](const Storehouse& s) { return &s == receiver; });
+    };
+
+    std::vector<std::uint32_t> offsets(node_count + 1, 0);
+    std::vector<std::uint32_t> targets;
+    std::vector<char> feeds_storehouse(node_count, 0);
+//    Odbiorca o pasujacym ID musi byc tez tym samym obiektem - obcy wezel o tym ID to wciaz odbiorca spoza fabryki
+    auto add_edges = [&](const PackageSender& sender, std::size_t v) {
+        const auto& keys = sender.receiver_preferences_.get_receiver_keys();
+        const auto& receivers = sender.receiver_preferences_.get_receivers();
+        for (std::size_t k = 0; k < keys.size(); ++k) {
+            if (keys[k].type == ReceiverType::STOREHOUSE) {
+                if (!is_own_storehouse(receivers[k], keys[k].id)) {
+                    throw std::logic_error("Odbiorca spoza fabryki.");
+                }
+                feeds_storehouse[v] = 1;
+            } else {
+                targets.push_back(worker_index(receivers[k], keys[k].id));
             }
-            if (node_colors[sendrecv_ptr] == NodeColor::UNVISITED) {
-                return has_reachable_storehouse(sendrecv_ptr, node_colors);
+        }
+        offsets[v + 1] = static_cast<std::uint32_t>(targets.size());
+    };
+    std::size_t v = 0;
+    for (const auto& ramp: ramps_) {
+        add_edges(ramp, v++);
+    }
+    for (auto worker: workers) {
+        add_edges(*worker, v++);
+    }
+
+//    Tarjan (iteracyjnie, z jawnym stosem wywolan): wezel dochodzi do magazynu, jesli sam do niego wysyla
+//    albo dochodzi do niego ktorykolwiek nastepnik. W obrebie silnie spojnej skladowej wynik jest wspolny,
+//    a skladowe koncza sie w odwrotnym porzadku topologicznym, wiec jedno przejscie wystarcza.
+    constexpr auto unvisited = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> order(node_count, unvisited);
+    std::vector<std::uint32_t> low(node_count);
+    std::vector<char> on_stack(node_count, 0);
+    std::vector<char> reaches_storehouse(feeds_storehouse);
+    std::vector<std::uint32_t> component_stack;
+    struct Frame {
+        std::uint32_t node;
+        std::uint32_t next_edge;
+    };
+    std::vector<Frame> frames;
+    std::uint32_t counter = 0;
+    auto enter = [&](std::uint32_t u) {
+        order[u] = low[u] = counter++;
+        component_stack.push_back(u);
+        on_stack[u] = 1;
+        frames.push_back({u, offsets[u]});
+    };
+    for (std::uint32_t root = 0; root < node_count; ++root) {
+        if (order[root] != unvisited) {
+            continue;
+        }
+        enter(root);
+        while (!frames.empty()) {
+            Frame& frame = frames.back();
+            const std::uint32_t u = frame.node;
+            if (frame.next_edge < offsets[u + 1]) {
+                const std::uint32_t w = targets[frame.next_edge++];
+                if (order[w] == unvisited) {
+                    enter(w);
+                } else if (on_stack[w]) {
+                    low[u] = std::min(low[u], order[w]);
+                } else {
+                    reaches_storehouse[u] |= reaches_storehouse[w];
+                }
+                continue;
+            }
+            frames.pop_back();
+            if (low[u] == order[u]) {
+                std::size_t first = component_stack.size();
+                char component_reaches = 0;
+                do {
+                    component_reaches |= reaches_storehouse[component_stack[--first]];
+                } while (component_stack[first] != u);
+                for (std::size_t i = first; i < component_stack.size(); ++i) {
+                    reaches_storehouse[component_stack[i]] = component_reaches;
+                    on_stack[component_stack[i]] = 0;
+                }
+                component_stack.resize(first);
+            }
+            if (!frames.empty()) {
+                const std::uint32_t parent = frames.back().node;
+                low[parent] = std::min(low[parent], low[u]);
+                reaches_storehouse[parent] |= reaches_storehouse[u];
             }
         }
     }
-    node_colors[sender] = NodeColor::VERIFIED;
-    if (does_sender_have_unique_receiver) {
-        return true;
-    } else {
-        throw std::logic_error("No unique receiver");
+
+//    Zasilanie z ramp trzeba ustalac tylko wtedy, gdy ktorys wezel nie dochodzi do magazynu
+    std::vector<char> fed_by_ramp(node_count, 0);
+    if (std::find(reaches_storehouse.begin(), reaches_storehouse.end(), 0) != reaches_storehouse.end()) {
+        std::vector<std::uint32_t> queue;
+        for (std::uint32_t u = 0; u < ramp_count; ++u) {
+            fed_by_ramp[u] = 1;
+            queue.push_back(u);
+        }
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            auto u = queue[head];
+            for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+                if (!fed_by_ramp[targets[e]]) {
+                    fed_by_ramp[targets[e]] = 1;
+                    queue.push_back(targets[e]);
+                }
+            }
+        }
     }
+
+    ConsistencyReport report;
+    v = 0;
+    for (const auto& ramp: ramps_) {
+        if (!reaches_storehouse[v++]) {
+            report.offending_ramps.push_back(ramp.get_id());
+        }
+    }
+    for (auto worker: workers) {
+        if (fed_by_ramp[v] and !reaches_storehouse[v]) {
+            report.offending_workers.push_back(worker->get_id());
+        }
+        v++;
+    }
+    std::sort(report.offending_ramps.begin(), report.offending_ramps.end());
+    std::sort(report.offending_workers.begin(), report.offending_workers.end());
+    report.consistent = report.offending_ramps.empty() and report.offending_workers.empty();
+    return report;
 }
 
+void Factory::add_ramp(Ramp&& ramp) {
+    ramp.set_context(*context_);
+    Ramp& added = ramps_.add(std::move(ramp));
+    tracker_->add_node(TrackedKind::RAMP, added.get_id(), nullptr);
+    added.receiver_preferences_.set_observer(tracker_.get(), SenderType::RAMP, added.get_id());
+    topology_changed();
+}
 
-bool Factory::is_consistent() const {
-    std::map<const PackageSender*, NodeColor> color_mapping;
-    for(auto& node: ramps_){
-        color_mapping.emplace(&node, NodeColor::UNVISITED);
+void Factory::remove_ramp(ElementID id) {
+    ramps_.remove_by_id(id);
+    untrack_node(TrackedKind::RAMP, id);
+    topology_changed();
+}
+
+void Factory::add_worker(Worker&& worker) {
+//    Sledzenie dostaje adres wezla juz w kolekcji - polaczenia prowadzace gdzie indziej sa spoza fabryki
+    Worker& added = workers_.add(std::move(worker));
+    tracker_->add_node(TrackedKind::WORKER, added.get_id(), &added);
+    added.receiver_preferences_.set_observer(tracker_.get(), SenderType::WORKER, added.get_id());
+    topology_changed();
+}
+
+void Factory::add_storehouse(Storehouse&& storehouse) {
+    Storehouse& added = storehouses_.add(std::move(storehouse));
+    tracker_->add_node(TrackedKind::STOREHOUSE, added.get_id(), &added);
+    topology_changed();
+}
+
+void Factory::untrack_node(TrackedKind kind, ElementID id) {
+    const bool duplicated = tracker_->has_duplicated_ids();
+    tracker_->remove_node(kind, id);
+    if (!duplicated or tracker_->has_duplicated_ids()) {
+        return;
     }
-    for(auto& node: workers_){
-        color_mapping.emplace(&node, NodeColor::UNVISITED);
+    tracker_->clear();
+    for (const auto& ramp: ramps_) {
+        tracker_->add_node(TrackedKind::RAMP, ramp.get_id(), nullptr);
     }
-    try{
-        for(auto& ramp: ramps_){
-            if (!has_reachable_storehouse(&ramp, color_mapping)) {
-                return false;
+    for (const auto& worker: workers_) {
+        tracker_->add_node(TrackedKind::WORKER, worker.get_id(), &worker);
+    }
+    for (const auto& storehouse: storehouses_) {
+        tracker_->add_node(TrackedKind::STOREHOUSE, storehouse.get_id(), &storehouse);
+    }
+    for (auto& ramp: ramps_) {
+        ramp.receiver_preferences_.set_observer(tracker_.get(), SenderType::RAMP, ramp.get_id());
+    }
+    for (auto& worker: workers_) {
+        worker.receiver_preferences_.set_observer(tracker_.get(), SenderType::WORKER, worker.get_id());
+    }
+}
+
+void Factory::remove_links_to(IPackageReceiver* receiver, TrackedKind kind) {
+    if (tracker_->is_exact()) {
+        for (auto [sender_kind, sender_id]: tracker_->get_predecessors(kind, receiver->get_id())) {
+            if (sender_kind == TrackedKind::RAMP) {
+                find_ramp_by_id(sender_id)->receiver_preferences_.remove_receiver(receiver);
+            } else {
+                find_worker_by_id(sender_id)->receiver_preferences_.remove_receiver(receiver);
             }
         }
-        return true;
+        return;
     }
-    catch (std::logic_error&) {
-        return false;
+    for (auto& ramp: ramps_) {
+        ramp.receiver_preferences_.remove_receiver(receiver);
+    }
+    for (auto& worker: workers_) {
+        worker.receiver_preferences_.remove_receiver(receiver);
     }
 }
 
 void Factory::remove_worker(ElementID id) {
-    remove_receiver(ramps_, id);
-    remove_receiver(workers_, id);
+    auto worker = workers_.find_by_id(id);
+    if (worker == workers_.end()) {
+        return;
+    }
+    remove_links_to(&*worker, TrackedKind::WORKER);
     workers_.remove_by_id(id);
+    untrack_node(TrackedKind::WORKER, id);
+    topology_changed();
 }
 
 void Factory::remove_storehouse(ElementID id) {
-    remove_receiver(workers_, id);
+    auto storehouse = storehouses_.find_by_id(id);
+    if (storehouse == storehouses_.end()) {
+        return;
+    }
+    remove_links_to(&*storehouse, TrackedKind::STOREHOUSE);
     storehouses_.remove_by_id(id);
+    untrack_node(TrackedKind::STOREHOUSE, id);
+    topology_changed();
 }
 
 void Factory::do_deliveries(Time t) {
+    context_->set_turn(t);
     for(auto& ramp: ramps_){
         ramp.deliver_goods(t);
     }
@@ -93,159 +329,139 @@ void Factory::do_work(Time t) {
     }
 }
 
+namespace {
 
-std::vector<std::string> split (std::string& line, char delim){
-    std::istringstream token_stream(line);
-    std::string token;
-    std::vector<std::string> tokens;
-    while (std::getline(token_stream, token, delim)) {
-        tokens.push_back(token);
+std::uint64_t sender_stream_id(SenderType type, ElementID id) {
+    return (static_cast<std::uint64_t>(type) << 32) | static_cast<std::uint32_t>(id);
+}
+
+}
+
+void Factory::seed_streams(std::uint64_t seed) {
+    for (auto& ramp: ramps_) {
+        ramp.receiver_preferences_.set_generator(RandomStream(seed, sender_stream_id(SenderType::RAMP, ramp.get_id())));
+    }
+    for (auto& worker: workers_) {
+        worker.receiver_preferences_.set_generator(RandomStream(seed, sender_stream_id(SenderType::WORKER, worker.get_id())));
     }
-    return tokens;
 }
 
-ParsedLineData parse_line(std::string line) {
+Factory::Factory(Factory&& other)
+        : context_(std::exchange(other.context_, std::make_unique<SimulationContext>())),
+          tracker_(std::exchange(other.tracker_, std::make_unique<ConsistencyTracker>())), ramps_(std::move(other.ramps_)), workers_(std::move(other.workers_)),
+          storehouses_(std::move(other.storehouses_)), ramp_views_(std::move(other.ramp_views_)),
+          worker_views_(std::move(other.worker_views_)), views_valid_(std::exchange(other.views_valid_, false)),
+          topology_version_(std::exchange(other.topology_version_, 0)) {}
 
-    const static std::unordered_map<std::string, ElementType> element_type_lookup {
-            {"LOADING_RAMP", ElementType::LOADING_RAMP },
-            {"WORKER", ElementType::WORKER},
-            {"STOREHOUSE", ElementType::STOREHOUSE},
-            {"LINK", ElementType::LINK}
-    };
+Factory& Factory::operator=(Factory&& other) {
+    if (this != &other) {
+//    Nowy stan dla `other` przydzielany przed zmianami, zeby wyjatek nie zostawil fabryk w polowie przeniesienia
+        auto fresh_context = std::make_unique<SimulationContext>();
+        auto fresh_tracker = std::make_unique<ConsistencyTracker>();
+//    Najpierw wezly - ich polprodukty zwracaja ID do starego kontekstu, ktory musi jeszcze istniec
+        storehouses_ = std::move(other.storehouses_);
+        workers_ = std::move(other.workers_);
+        ramps_ = std::move(other.ramps_);
+        context_ = std::exchange(other.context_, std::move(fresh_context));
+        tracker_ = std::exchange(other.tracker_, std::move(fresh_tracker));
+        ramp_views_ = std::move(other.ramp_views_);
+        worker_views_ = std::move(other.worker_views_);
+        views_valid_ = std::exchange(other.views_valid_, false);
+        topology_version_ = std::exchange(other.topology_version_, 0);
+    }
+    return *this;
+}
 
-    std::map<std::string, std::string> id_tokens;
-    ParsedLineData parsed_data;
-    std::vector<std::string> tokens = split(line, ' ');
-    std::string tag = tokens[0];
-    try{
-        parsed_data.element_type = element_type_lookup.at(tag);
-    } catch (const std::out_of_range&) {
-        throw std::logic_error("bledny identyfikator ElementType");
-    }
-    for(auto iter = tokens.begin() + 1; iter != tokens.end(); iter++){
-        std::vector<std::string> id_val = split(*iter, '=');
-        id_tokens[id_val[0]] = id_val[1];
-    }
-    parsed_data.parameters = id_tokens;
-    return parsed_data;
+void Factory::update_views() {
+    if (views_valid_) {
+        return;
+    }
+    ramp_views_.clear();
+    worker_views_.clear();
+    for (auto& ramp: ramps_) {
+        ramp_views_.push_back(&ramp);
+    }
+    for (auto& worker: workers_) {
+        worker_views_.push_back(&worker);
+    }
+    views_valid_ = true;
 }
 
-Factory load_factory_structure(std::istream& is){
-    Factory factory;
-    std::vector<ParsedLineData> parsed_lines;
-    std::string line;
-    while (std::getline(is, line)) {
-        if(line[0] != ';' and !line.empty()){
-            parsed_lines.emplace_back(parse_line(line));
+void Factory::do_deliveries(Time t, ThreadPool& pool) {
+    context_->set_turn(t);
+    update_views();
+    std::vector<char> due(ramp_views_.size());
+    pool.parallel_for(ramp_views_.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            due[i] = ramp_views_[i]->is_delivery_due(t);
+        }
+    });
+//    ID przydzielane sa w kolejnosci ramp, tak jak w wersji sekwencyjnej
+    std::vector<ElementID> ids(ramp_views_.size(), 0);
+    for (std::size_t i = 0; i < ramp_views_.size(); ++i) {
+        if (due[i]) {
+            ids[i] = context_->id_allocator().allocate();
         }
     }
-    for(auto& parsed_line: parsed_lines){
-        switch (parsed_line.element_type) {
-            case ElementType::LOADING_RAMP: {
-                ElementID id_ramp;
-                TimeOffset di_ramp;
-                for (const auto& pair: parsed_line.parameters) {
-                    if (pair.first == "id") {
-                        id_ramp = std::stoi(pair.second);
-                    } else if (pair.first == "delivery-interval") {
-                        di_ramp = std::stoi(pair.second);
-                    }
-                }
-                factory.add_ramp(Ramp(id_ramp, di_ramp));
-                break;
-            }
-            case ElementType::WORKER: {
-                ElementID id_worker;
-                TimeOffset di_worker;
-                std::unique_ptr<IPackageQueue> q;
-                for (const auto& pair: parsed_line.parameters) {
-                    if (pair.first == "id") {
-                        id_worker = std::stoi(pair.second);
-                    } else if (pair.first == "processing-time") {
-                        di_worker = std::stoi(pair.second);
-                    } else if (pair.first == "queue-type") {
-                        const static std::unordered_map<std::string, PackageQueueType> package_queue_type_lookup{
-                                {"FIFO", PackageQueueType::FIFO},
-                                {"LIFO", PackageQueueType::LIFO}
-                        };
-                        PackageQueueType chosen_type = package_queue_type_lookup.at(pair.second);
-                        switch (chosen_type) {
-                            case PackageQueueType::FIFO:
-                                q = std::make_unique<PackageQueue>(PackageQueueType::FIFO);
-                                break;
-                            case PackageQueueType::LIFO:
-                                q = std::make_unique<PackageQueue>(PackageQueueType::LIFO);
-                                break;
-                        }
-                    }
-                }
-                factory.add_worker(Worker(id_worker, di_worker, std::move(q)));
-                break;
-            }
-            case ElementType::STOREHOUSE: {
-                ElementID id_store;
-                for (const auto& pair: parsed_line.parameters) {
-                    if (pair.first == "id") {
-                        id_store = std::stoi(pair.second);
-                    }
-                }
-                factory.add_storehouse(Storehouse(id_store));
-                break;
-            }
-            case ElementType::LINK: {
-
-                const static std::unordered_map<std::string, SenderType> sender_type_lookup{
-                        {"ramp",   SenderType::RAMP},
-                        {"worker", SenderType::WORKER}
-                };
-
-                const static std::unordered_map<std::string, ReceiverType> receiver_type_lookup{
-                        {"worker", ReceiverType::WORKER},
-                        {"store",  ReceiverType::STOREHOUSE}
-                };
-
-                const static std::unordered_map<std::string, NodeType> node_type_lookup{
-                        {"src",  NodeType::SENDER},
-                        {"dest", NodeType::RECEIVER}
-                };
-
-                IPackageReceiver* rec_p;
-                PackageSender* send_p;
-                ReceiverType receiver_type;
-                SenderType sender_type;
-                for (auto pair: parsed_line.parameters) {
-                    std::vector<std::string> type_id = split(pair.second, '-');
-                    NodeType node_type = node_type_lookup.at(pair.first);
-                    ElementID node_id = std::stoi(type_id[1]);
-                    switch (node_type) {
-                        case NodeType::RECEIVER:
-                            receiver_type = receiver_type_lookup.at(type_id[0]);
-                            switch (receiver_type) {
-                                case ReceiverType::WORKER:
-                                    rec_p = &*factory.find_worker_by_id(node_id);
-                                    break;
-                                case ReceiverType::STOREHOUSE:
-                                    rec_p = &*factory.find_storehouse_by_id(node_id);
-                                    break;
-                            } break;
-                        case NodeType::SENDER:
-                            sender_type = sender_type_lookup.at(type_id[0]);
-                            switch (sender_type) {
-                                case SenderType::RAMP:
-                                    send_p = &*factory.find_ramp_by_id(node_id);
-                                    break;
-                                case SenderType::WORKER:
-                                    send_p = &*factory.find_worker_by_id(node_id);
-                                    break;
-                            } break;
-                }
-            }
-            send_p->receiver_preferences_.add_receiver(rec_p);
-            break;
+    pool.parallel_for(ramp_views_.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (due[i]) {
+                ramp_views_[i]->deliver_package(Package(ids[i], *context_), t);
             }
         }
+    });
+}
+
+void Factory::do_package_passing(ThreadPool& pool) {
+    update_views();
+    struct Transfer {
+        IPackageReceiver* receiver;
+        PackageSender* sender;
+    };
+    std::vector<Transfer> transfers;
+//    Faza 1 (sekwencyjna): losowanie odbiorcow w kolejnosci nadawcow
+    for (auto ramp: ramp_views_) {
+        if (ramp->get_sending_buffer()) {
+            transfers.push_back({ramp->receiver_preferences_.choose_receiver(), ramp});
+        }
     }
-    return factory;
+    for (auto worker: worker_views_) {
+        if (worker->get_sending_buffer()) {
+            transfers.push_back({worker->receiver_preferences_.choose_receiver(), worker});
+        }
+    }
+//    Faza 2 (rownolegla): kazdy odbiorca dostaje swoje polprodukty w kolejnosci nadawcow
+    std::stable_sort(transfers.begin(), transfers.end(), [](const Transfer& a, const Transfer& b) { return a.receiver < b.receiver; });
+    std::vector<std::size_t> groups;
+    for (std::size_t i = 0; i < transfers.size(); ++i) {
+        if (i == 0 || transfers[i].receiver != transfers[i - 1].receiver) {
+            groups.push_back(i);
+        }
+    }
+    groups.push_back(transfers.size());
+    pool.parallel_for(groups.size() - 1, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t g = begin; g < end; ++g) {
+            for (std::size_t i = groups[g]; i < groups[g + 1]; ++i) {
+                transfers[i].sender->send_package_to(transfers[i].receiver);
+            }
+        }
+    });
+}
+
+void Factory::do_work(Time t, ThreadPool& pool) {
+    update_views();
+    pool.parallel_for(worker_views_.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            worker_views_[i]->do_work(t);
+        }
+    });
+}
+
+
+Factory load_factory_structure(std::istream& is){
+//    Caly tekst naraz, a potem parser na string_view - bez kopii linii i tokenow
+    std::string text(std::istreambuf_iterator<char>(is), {});
+    return parse_factory_structure(text);
 }
 
 
@@ -285,18 +501,28 @@ void save_factory_structure(Factory& factory, std::ostream& os){
     if(any_ramps or any_workers){
         os << "; == LINKS ==" << std::endl << std::endl;
         for(auto it_ramp = factory.ramp_cbegin(); it_ramp != factory.ramp_cend(); it_ramp++){
+            bool is_uniform = it_ramp->receiver_preferences_.is_uniform();
             for(auto it_pref = it_ramp->receiver_preferences_.cbegin(); it_pref != it_ramp->receiver_preferences_.cend(); it_pref++){
-                os << "LINK src=ramp-" << it_ramp->get_id() << " dest=worker-" << it_pref->first->get_id() << std::endl;
+                os << "LINK src=ramp-" << it_ramp->get_id() << " dest=worker-" << it_pref->first->get_id();
+                if (!is_uniform) {
+                    os << " p=" << weight_to_string(it_ramp->receiver_preferences_.get_weight(it_pref->first));
+                }
+                os << std::endl;
             }
             os << std::endl;
         }
         for(auto it_worker = factory.worker_cbegin(); it_worker != factory.worker_cend(); it_worker++){
+            bool is_uniform = it_worker->receiver_preferences_.is_uniform();
             for(auto it_pref = it_worker->receiver_preferences_.cbegin(); it_pref != it_worker->receiver_preferences_.cend(); it_pref++){
                 if(it_pref->first->get_receiver_type() == ReceiverType::WORKER) {
-                    os << "LINK src=worker-" << it_worker->get_id() << " dest=worker-" << it_pref->first->get_id() << std::endl;
+                    os << "LINK src=worker-" << it_worker->get_id() << " dest=worker-" << it_pref->first->get_id();
                 } else if (it_pref->first->get_receiver_type() == ReceiverType::STOREHOUSE) {
-                    os << "LINK src=worker-" << it_worker->get_id() << " dest=store-" << it_pref->first->get_id() << std::endl;
+                    os << "LINK src=worker-" << it_worker->get_id() << " dest=store-" << it_pref->first->get_id();
+                }
+                if (!is_uniform) {
+                    os << " p=" << weight_to_string(it_worker->receiver_preferences_.get_weight(it_pref->first));
                 }
+                os << std::endl;
             }
             os << std::endl;
         }
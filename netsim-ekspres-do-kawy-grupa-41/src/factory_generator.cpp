@@ -0,0 +1,169 @@
+#include "factory_generator.hpp"
+
+#include "random.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct Target {
+    bool storehouse;
+    ElementID id;
+};
+
+bool operator==(const Target& a, const Target& b) {
+    return a.storehouse == b.storehouse and a.id == b.id;
+}
+
+// Wezly i polaczenia wylosowanej sieci - wspolne dla wyjscia tekstowego i budowy Factory
+struct FactoryPlan {
+    std::vector<TimeOffset> delivery_intervals;         // rampy 1..R
+    std::vector<TimeOffset> processing_times;           // robotnicy 1..W
+    std::vector<PackageQueueType> queue_types;
+    ElementID storehouses = 0;
+    std::vector<std::vector<ElementID>> ramp_receivers;
+    std::vector<std::vector<Target>> worker_receivers;
+};
+
+void validate(const FactoryGeneratorOptions& options) {
+    auto valid_range = [](UniformRange r) { return r.min >= 1 and r.min <= r.max; };
+    if (options.ramps < 1 or options.workers < 1 or options.storehouses < 1 or options.layers < 1) {
+        throw std::invalid_argument("Liczby ramp, robotnikow, magazynow i warstw musza byc dodatnie.");
+    }
+    if (!valid_range(options.fan_out) or !valid_range(options.processing_time) or !valid_range(options.delivery_interval)) {
+        throw std::invalid_argument("Przedzialy musza spelniac 1 <= min <= max.");
+    }
+    if (!(options.lifo_fraction >= 0 and options.lifo_fraction <= 1)) {
+        throw std::invalid_argument("Udzial kolejek LIFO musi byc z przedzialu [0, 1].");
+    }
+}
+
+FactoryPlan make_plan(const FactoryGeneratorOptions& options) {
+    validate(options);
+    RandomStream random(options.seed);
+    auto draw = [&random](int min, int max) {
+        const auto span = static_cast<double>(max - min + 1);
+        return min + std::min(max - min, static_cast<int>(random() * span));
+    };
+
+    FactoryPlan plan;
+    plan.storehouses = options.storehouses;
+    for (ElementID id = 1; id <= options.ramps; ++id) {
+        plan.delivery_intervals.push_back(draw(options.delivery_interval.min, options.delivery_interval.max));
+    }
+    for (ElementID id = 1; id <= options.workers; ++id) {
+        plan.processing_times.push_back(draw(options.processing_time.min, options.processing_time.max));
+        plan.queue_types.push_back(random() < options.lifo_fraction ? PackageQueueType::LIFO : PackageQueueType::FIFO);
+    }
+
+//    Warstwa k to robotnicy o ID z [layer_begin[k], layer_begin[k + 1]) - pierwsze warstwy sa o jeden wieksze
+    const ElementID layers = std::min<ElementID>(options.layers, options.workers);
+    std::vector<ElementID> layer_begin(static_cast<std::size_t>(layers) + 1, 1);
+    for (ElementID k = 0; k < layers; ++k) {
+        layer_begin[k + 1] = layer_begin[k] + options.workers / layers + (k < options.workers % layers ? 1 : 0);
+    }
+
+//    Kazdy wezel warstwy (i magazyn) dostaje nadawce z poprzedniej warstwy po kolei, reszte odbiorcow
+//    do wylosowanej liczby dobiera sie losowo bez powtorzen.
+    auto connect = [&](auto& receivers, ElementID senders, ElementID first, ElementID count, auto make_target) {
+        receivers.resize(static_cast<std::size_t>(senders));
+        for (ElementID i = 0; i < count; ++i) {
+            receivers[static_cast<std::size_t>(i % senders)].push_back(make_target(first + i));
+        }
+        for (auto& chosen: receivers) {
+            const auto wanted = static_cast<std::size_t>(std::min<ElementID>(draw(options.fan_out.min, options.fan_out.max), count));
+            while (chosen.size() < wanted) {
+                auto target = make_target(first + draw(0, count - 1));
+                if (std::none_of(chosen.begin(), chosen.end(), [&target](const auto& c) { return c == target; })) {
+                    chosen.push_back(target);
+                }
+            }
+        }
+    };
+    connect(plan.ramp_receivers, options.ramps, layer_begin[0], layer_begin[1] - layer_begin[0], [](ElementID id) { return id; });
+
+    plan.worker_receivers.resize(static_cast<std::size_t>(options.workers));
+    auto same = [](bool storehouse) {
+        return [storehouse](ElementID id) { return Target{storehouse, id}; };
+    };
+    for (ElementID k = 0; k < layers; ++k) {
+        std::vector<std::vector<Target>> layer_receivers;
+        const ElementID senders = layer_begin[k + 1] - layer_begin[k];
+        if (k + 1 < layers) {
+            connect(layer_receivers, senders, layer_begin[k + 1], layer_begin[k + 2] - layer_begin[k + 1], same(false));
+        } else {
+            connect(layer_receivers, senders, 1, options.storehouses, same(true));
+        }
+        std::move(layer_receivers.begin(), layer_receivers.end(), plan.worker_receivers.begin() + (layer_begin[k] - 1));
+    }
+    return plan;
+}
+
+}
+
+void generate_factory_structure(const FactoryGeneratorOptions& options, std::ostream& os) {
+    const FactoryPlan plan = make_plan(options);
+    os << "; == LOADING RAMPS ==\n\n";
+    for (std::size_t i = 0; i < plan.delivery_intervals.size(); ++i) {
+        os << "LOADING_RAMP id=" << i + 1 << " delivery-interval=" << plan.delivery_intervals[i] << "\n";
+    }
+    os << "\n; == WORKERS ==\n\n";
+    for (std::size_t i = 0; i < plan.processing_times.size(); ++i) {
+        os << "WORKER id=" << i + 1 << " processing-time=" << plan.processing_times[i]
+           << " queue-type=" << (plan.queue_types[i] == PackageQueueType::LIFO ? "LIFO" : "FIFO") << "\n";
+    }
+    os << "\n; == STOREHOUSES ==\n\n";
+    for (ElementID id = 1; id <= plan.storehouses; ++id) {
+        os << "STOREHOUSE id=" << id << "\n";
+    }
+    os << "\n; == LINKS ==\n\n";
+    for (std::size_t i = 0; i < plan.ramp_receivers.size(); ++i) {
+        for (ElementID receiver: plan.ramp_receivers[i]) {
+            os << "LINK src=ramp-" << i + 1 << " dest=worker-" << receiver << "\n";
+        }
+        os << "\n";
+    }
+    for (std::size_t i = 0; i < plan.worker_receivers.size(); ++i) {
+        for (const Target& receiver: plan.worker_receivers[i]) {
+            os << "LINK src=worker-" << i + 1 << (receiver.storehouse ? " dest=store-" : " dest=worker-") << receiver.id << "\n";
+        }
+        os << "\n";
+    }
+}
+
+Factory generate_factory(const FactoryGeneratorOptions& options) {
+    const FactoryPlan plan = make_plan(options);
+    Factory factory;
+    for (std::size_t i = 0; i < plan.delivery_intervals.size(); ++i) {
+        factory.add_ramp(Ramp(static_cast<ElementID>(i + 1), plan.delivery_intervals[i]));
+    }
+    for (std::size_t i = 0; i < plan.processing_times.size(); ++i) {
+        factory.add_worker(Worker(static_cast<ElementID>(i + 1), plan.processing_times[i], std::make_unique<PackageQueue>(plan.queue_types[i])));
+    }
+    for (ElementID id = 1; id <= plan.storehouses; ++id) {
+        factory.add_storehouse(Storehouse(id));
+    }
+//    Jak przy wczytywaniu: wszystkie polaczenia nadawcy dodawane bez przebudowy tablicy aliasow, potem jedna przebudowa
+    for (std::size_t i = 0; i < plan.ramp_receivers.size(); ++i) {
+        auto& preferences = factory.find_ramp_by_id(static_cast<ElementID>(i + 1))->receiver_preferences_;
+        for (ElementID receiver: plan.ramp_receivers[i]) {
+            preferences.add_receiver_deferred(&*factory.find_worker_by_id(receiver));
+        }
+        preferences.rebuild();
+    }
+    for (std::size_t i = 0; i < plan.worker_receivers.size(); ++i) {
+        auto& preferences = factory.find_worker_by_id(static_cast<ElementID>(i + 1))->receiver_preferences_;
+        for (const Target& receiver: plan.worker_receivers[i]) {
+            if (receiver.storehouse) {
+                preferences.add_receiver_deferred(&*factory.find_storehouse_by_id(receiver.id));
+            } else {
+                preferences.add_receiver_deferred(&*factory.find_worker_by_id(receiver.id));
+            }
+        }
+        preferences.rebuild();
+    }
+    return factory;
+}
@@ -0,0 +1,248 @@
+#include "fast_forward.hpp"
+
+#include "latency.hpp"
+#include "metrics.hpp"
+#include "random.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <typeinfo>
+
+namespace {
+
+std::uint64_t mix(std::uint64_t h, std::int64_t value) {
+    h ^= static_cast<std::uint64_t>(value) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+    return h;
+}
+
+// Wspolny porzadek przegladania stanu (uzywany przez skrot, zrzut i przeskok): rampy, potem robotnicy
+// w kolejnosci kolekcji fabryki; u robotnika kolejka (w kolejnosci iteracji), bufor przetwarzania, bufor wysylki.
+template <class ShapeVisitor>
+void visit_shape(Factory& factory, Time t, ShapeVisitor&& shape) {
+    for (auto it = factory.ramp_begin(); it != factory.ramp_end(); ++it) {
+        shape(t % it->get_delivery_interval());
+        shape(it->get_sending_buffer().has_value());
+    }
+    for (auto it = factory.worker_begin(); it != factory.worker_end(); ++it) {
+        shape(static_cast<std::int64_t>(it->get_queue()->size()));
+        shape(it->get_processing_buffer() ? t - it->get_package_processing_start_time() : -1);
+        shape(it->get_sending_buffer().has_value());
+    }
+}
+
+const RandomStream* find_stream(const PackageSender& sender) {
+    return sender.receiver_preferences_.get_generator().target<RandomStream>();
+}
+
+}
+
+PeriodicFastForward::PeriodicFastForward(Factory& factory, TimeOffset max_period)
+        : factory_(&factory), applicable_(!node_metrics_enabled and !package_latency_enabled), max_period_(max_period) {
+    for (auto it = factory.ramp_cbegin(); it != factory.ramp_cend(); ++it) {
+        applicable_ = applicable_ and it->receiver_preferences_.get_receivers().size() == 1;
+    }
+    for (auto it = factory.worker_cbegin(); it != factory.worker_cend(); ++it) {
+        const IPackageQueue* q = it->get_queue();
+        applicable_ = applicable_ and it->receiver_preferences_.get_receivers().size() == 1 and typeid(*q) == typeid(PackageQueue);
+    }
+}
+
+void PeriodicFastForward::reset() {
+    seen_.clear();
+    period_ = 0;
+    snapshots_.clear();
+}
+
+std::uint64_t PeriodicFastForward::shape_hash(Time t) const {
+    std::uint64_t h = 0;
+    visit_shape(*factory_, t, [&h](std::int64_t value) { h = mix(h, value); });
+    return h;
+}
+
+PeriodicFastForward::Snapshot PeriodicFastForward::capture(Time t) const {
+    Snapshot s;
+    s.turn = t;
+    visit_shape(*factory_, t, [&s](std::int64_t value) { s.shape.push_back(value); });
+    for (auto it = factory_->ramp_cbegin(); it != factory_->ramp_cend(); ++it) {
+        if (it->get_sending_buffer()) {
+            s.ids.push_back(it->get_sending_buffer()->get_id());
+        }
+        const RandomStream* stream = find_stream(*it);
+        s.stream_positions.push_back(stream ? stream->get_position() : 0);
+    }
+    for (auto it = factory_->worker_cbegin(); it != factory_->worker_cend(); ++it) {
+        for (const auto& package: *it) {
+            s.ids.push_back(package.get_id());
+        }
+        if (it->get_processing_buffer()) {
+            s.ids.push_back(it->get_processing_buffer()->get_id());
+        }
+        if (it->get_sending_buffer()) {
+            s.ids.push_back(it->get_sending_buffer()->get_id());
+        }
+        const RandomStream* stream = find_stream(*it);
+        s.stream_positions.push_back(stream ? stream->get_position() : 0);
+    }
+    for (auto it = factory_->storehouse_cbegin(); it != factory_->storehouse_cend(); ++it) {
+        s.storehouse_sizes.push_back(static_cast<std::size_t>(it->cend() - it->cbegin()));
+        s.complete_stock = s.complete_stock and it->get_received_count() == s.storehouse_sizes.back();
+    }
+    s.next_fresh_id = factory_->get_context().id_allocator().get_next_fresh_id();
+    return s;
+}
+
+bool PeriodicFastForward::repeats(const Snapshot& a, const Snapshot& b, const Snapshot& c) const {
+    const ElementID fresh = b.next_fresh_id - a.next_fresh_id;
+    if (!c.complete_stock or c.next_fresh_id - b.next_fresh_id != fresh or a.shape != b.shape or b.shape != c.shape or a.ids.size() != c.ids.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.ids.size(); ++i) {
+        const ElementID shift = b.ids[i] - a.ids[i];
+        if (c.ids[i] - b.ids[i] != shift or (shift != 0 and shift != fresh)) {
+            return false;
+        }
+    }
+    for (std::size_t i = 0; i < a.stream_positions.size(); ++i) {
+        if (c.stream_positions[i] - b.stream_positions[i] != b.stream_positions[i] - a.stream_positions[i]) {
+            return false;
+        }
+    }
+    std::size_t s = 0;
+    for (auto it = factory_->storehouse_cbegin(); it != factory_->storehouse_cend(); ++it, ++s) {
+        const std::size_t received = b.storehouse_sizes[s] - a.storehouse_sizes[s];
+        if (c.storehouse_sizes[s] - b.storehouse_sizes[s] != received) {
+            return false;
+        }
+        auto first = it->cbegin() + static_cast<std::ptrdiff_t>(a.storehouse_sizes[s]);
+        auto second = it->cbegin() + static_cast<std::ptrdiff_t>(b.storehouse_sizes[s]);
+        for (std::size_t j = 0; j < received; ++j, ++first, ++second) {
+            if (second->get_id() != first->get_id() + fresh) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+TimeOffset PeriodicFastForward::observe(Time t) {
+    if (!applicable_) {
+        return 0;
+    }
+    if (factory_->get_context().id_allocator().has_freed_ids()) {
+        reset();
+        return 0;
+    }
+    if (period_ == 0) {
+        const std::uint64_t h = shape_hash(t);
+        auto [it, inserted] = seen_.try_emplace(h, t);
+        if (inserted) {
+            if (seen_.size() > static_cast<std::size_t>(max_period_)) {
+                seen_.clear();
+                seen_.emplace(h, t);
+            }
+            return 0;
+        }
+        period_ = t - it->second;
+        seen_.clear();
+        snapshots_.assign(1, capture(t));
+        return 0;
+    }
+    if (t - snapshots_.back().turn < period_) {
+        return 0;
+    }
+    snapshots_.push_back(capture(t));
+    if (snapshots_.back().shape != snapshots_.front().shape) {
+        reset();
+        return 0;
+    }
+    if (snapshots_.size() < 3) {
+        return 0;
+    }
+    if (!repeats(snapshots_[0], snapshots_[1], snapshots_[2])) {
+        reset();
+        return 0;
+    }
+//    Dwa ostatnie zrzuty wystarcza do przeskoku albo do potwierdzenia kolejnego okresu
+    snapshots_.erase(snapshots_.begin());
+    return period_;
+}
+
+FastForwardSpan PeriodicFastForward::skip(Time t, Time periods) {
+    if (snapshots_.size() != 2 or snapshots_.back().turn != t or periods < 1) {
+        throw std::logic_error("Przeskok bez potwierdzonego okresu.");
+    }
+    const Snapshot& before = snapshots_[0];
+    const Snapshot& now = snapshots_[1];
+    const ElementID fresh = now.next_fresh_id - before.next_fresh_id;
+    const std::int64_t next_fresh_id = now.next_fresh_id + static_cast<std::int64_t>(periods) * fresh;
+    const std::int64_t last_turn = t + static_cast<std::int64_t>(periods) * period_;
+    if (next_fresh_id > std::numeric_limits<ElementID>::max() or last_turn > std::numeric_limits<Time>::max()) {
+        throw std::overflow_error("Przeskok poza zakres ElementID/Time.");
+    }
+
+    SimulationContext& context = factory_->get_context();
+    std::size_t position = 0;
+    auto next_package = [&]() {
+        const ElementID id = now.ids[position];
+        const ElementID shift = id - before.ids[position];
+        ++position;
+        return Package(id + periods * shift, context);
+    };
+    auto advance_stream = [&](PackageSender& sender, std::size_t index) {
+        if (const RandomStream* stream = find_stream(sender)) {
+            RandomStream advanced = *stream;
+            const std::uint64_t draws = now.stream_positions[index] - before.stream_positions[index];
+            advanced.seek(now.stream_positions[index] + static_cast<std::uint64_t>(periods) * draws);
+            sender.receiver_preferences_.set_generator(advanced);
+        }
+    };
+
+//    Stare polprodukty sa niszczone, a nowe przejmuja wyliczone ID - pule ustawia sie na koniec w calosci.
+    std::size_t sender = 0;
+    for (auto it = factory_->ramp_begin(); it != factory_->ramp_end(); ++it, ++sender) {
+        if (it->get_sending_buffer()) {
+            it->restore_sending_buffer(next_package());
+        }
+        advance_stream(*it, sender);
+    }
+    for (auto it = factory_->worker_begin(); it != factory_->worker_end(); ++it, ++sender) {
+        IPackageQueue* q = it->get_queue();
+        std::vector<Package> queued;
+        queued.reserve(q->size());
+        for (std::size_t i = q->size(); i > 0; --i) {
+            queued.push_back(next_package());
+        }
+        while (!q->empty()) {
+            q->pop();
+        }
+        for (auto& package: queued) {
+            q->push(std::move(package));
+        }
+        if (it->get_processing_buffer()) {
+            Package processed = next_package();
+            it->restore_processing_buffer(std::move(processed), it->get_package_processing_start_time() + periods * period_);
+        }
+        if (it->get_sending_buffer()) {
+            it->restore_sending_buffer(next_package());
+        }
+        advance_stream(*it, sender);
+    }
+
+    FastForwardSpan span{t + 1, static_cast<Time>(last_turn), period_, periods, static_cast<std::uint64_t>(periods) * static_cast<std::uint64_t>(fresh), {}};
+    std::size_t s = 0;
+    for (auto it = factory_->storehouse_begin(); it != factory_->storehouse_end(); ++it, ++s) {
+        std::vector<ElementID> received;
+        for (auto p = it->cbegin() + static_cast<std::ptrdiff_t>(before.storehouse_sizes[s]); p != it->cend(); ++p) {
+            received.push_back(p->get_id());
+        }
+        for (Time k = 1; k <= periods; ++k) {
+            for (ElementID id: received) {
+                it->receive_package(Package(id + k * fresh, context));
+            }
+        }
+        span.storehouse_packages.emplace_back(it->get_id(), static_cast<std::uint64_t>(periods) * received.size());
+    }
+    context.id_allocator().restore(static_cast<ElementID>(next_fresh_id), {});
+    reset();
+    return span;
+}
@@ -4,21 +4,16 @@
 
 #include "helpers.hpp"
 
-#include <cstdlib>
 #include <random>
 
-std::random_device rd;
-std::mt19937 rng(rd());
+thread_local RandomStream rng((static_cast<std::uint64_t>(std::random_device{}()) << 32) | std::random_device{}());
 
-double default_probability_generator() {
-    return std::generate_canonical<double, 10>(rng);
+void seed_rng(std::uint64_t seed) {
+    rng = RandomStream(seed);
 }
 
-double rigged_probability_generator() {
-    static int calls = 0;
-    calls ++;
-    return calls == 1 ? 0.3 : 0.7;
+double default_probability_generator() {
+    return rng();
 }
 
-
-std::function<double()> probability_generator = rigged_probability_generator;
+thread_local std::function<double()> probability_generator = default_probability_generator;
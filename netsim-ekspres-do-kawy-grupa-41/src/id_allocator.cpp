@@ -0,0 +1,90 @@
+#include "id_allocator.hpp"
+
+ElementID IdAllocator::allocate() {
+//    Jesli nie ma wolnych ID
+    if (!has_freed_ids()) {
+        return next_fresh_id_++;
+    }
+//    Zejscie od korzenia do najmniejszego ustawionego bitu
+    std::size_t index = 0;
+    for (std::size_t level = levels_.size(); level-- > 0;) {
+        index = index * word_bits + static_cast<std::size_t>(__builtin_ctzll(levels_[level][index]));
+    }
+    const auto id = static_cast<ElementID>(index);
+    for (auto& words: levels_) {
+        word_t& word = words[index / word_bits];
+        word &= ~(word_t(1) << (index % word_bits));
+        if (word != 0) {
+            break;
+        }
+        index /= word_bits;
+    }
+    return id;
+}
+
+void IdAllocator::release(ElementID id) {
+    if (id < 0) {
+        return;
+    }
+    if (id >= next_fresh_id_) {
+        next_fresh_id_ = id + 1;
+    }
+    auto index = static_cast<std::size_t>(id);
+    reserve(index + 1);
+    for (auto& words: levels_) {
+        word_t& word = words[index / word_bits];
+        bool was_empty = word == 0;
+        word |= word_t(1) << (index % word_bits);
+        if (!was_empty) {
+            break;
+        }
+        index /= word_bits;
+    }
+}
+
+void IdAllocator::reserve(std::size_t bits) {
+    std::size_t words = (bits + word_bits - 1) / word_bits;
+    if (levels_.empty()) {
+        levels_.emplace_back(1, 0);
+    }
+    if (words <= levels_.front().size()) {
+        return;
+    }
+    levels_.front().resize(words, 0);
+    for (std::size_t level = 0; levels_[level].size() > 1; ++level) {
+        std::size_t parent_words = (levels_[level].size() + word_bits - 1) / word_bits;
+        if (level + 1 < levels_.size()) {
+            levels_[level + 1].resize(parent_words, 0);
+            continue;
+        }
+//        Nowy korzen - trzeba oznaczyc w nim niepuste slowa dotychczasowego korzenia
+        levels_.emplace_back(parent_words, 0);
+        for (std::size_t i = 0; i < levels_[level].size(); ++i) {
+            if (levels_[level][i] != 0) {
+                levels_[level + 1][i / word_bits] |= word_t(1) << (i % word_bits);
+            }
+        }
+    }
+}
+
+std::vector<ElementID> IdAllocator::get_freed_ids() const {
+    std::vector<ElementID> freed_ids;
+    if (levels_.empty()) {
+        return freed_ids;
+    }
+    const auto& words = levels_.front();
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        for (word_t word = words[w]; word != 0; word &= word - 1) {
+            freed_ids.push_back(static_cast<ElementID>(w * word_bits + static_cast<std::size_t>(__builtin_ctzll(word))));
+        }
+    }
+    return freed_ids;
+}
+
+void IdAllocator::restore(ElementID next_fresh_id, const std::vector<ElementID>& freed_ids) {
+    levels_.clear();
+    for (auto id: freed_ids) {
+        release(id);
+    }
+    next_fresh_id_ = next_fresh_id;
+}
@@ -0,0 +1,71 @@
+#include "latency.hpp"
+
+#include <cmath>
+
+std::size_t LatencyHistogram::bucket_index(std::uint32_t value) {
+    if (value < 2 * sub_bucket_count) {
+        return value;
+    }
+#if defined(__GNUC__)
+    const unsigned top_bit = 31u - static_cast<unsigned>(__builtin_clz(value));
+#else
+    unsigned top_bit = 0;
+    for (std::uint32_t v = value; v > 1; v >>= 1) {
+        ++top_bit;
+    }
+#endif
+//    Dla wartosci z [2^b, 2^(b+1)) przesuniecie zostawia sub_bucket_bits + 1 najstarszych bitow
+    const unsigned shift = top_bit - sub_bucket_bits;
+    return (shift + 1) * sub_bucket_count + (value >> shift) - sub_bucket_count;
+}
+
+std::uint32_t LatencyHistogram::bucket_upper_bound(std::size_t index) {
+    if (index < 2 * sub_bucket_count) {
+        return static_cast<std::uint32_t>(index);
+    }
+    const std::size_t shift = index / sub_bucket_count - 1;
+    const std::uint64_t sub_bucket = index % sub_bucket_count + sub_bucket_count;
+    return static_cast<std::uint32_t>(((sub_bucket + 1) << shift) - 1);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        counts_[i] += other.counts_[i];
+    }
+    min_ = count_ == 0 or other.min_ < min_ ? other.min_ : min_;
+    max_ = other.max_ > max_ ? other.max_ : max_;
+    count_ += other.count_;
+    sum_ += other.sum_;
+}
+
+std::uint32_t LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    const double wanted = std::ceil(q * static_cast<double>(count_));
+    const std::uint64_t rank = wanted < 1.0 ? 1 : static_cast<std::uint64_t>(wanted);
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucket_count; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            const std::uint32_t upper = bucket_upper_bound(i);
+            return upper < max_ ? upper : max_;
+        }
+    }
+    return max_;
+}
+
+#if !defined(WITH_PACKAGE_LATENCY)
+const LatencyHistogram& LatencyRecorder::get_total() const {
+    static const LatencyHistogram empty;
+    return empty;
+}
+
+const LatencyRecorder::path_histograms_t& LatencyRecorder::get_paths() const {
+    static const path_histograms_t empty;
+    return empty;
+}
+#endif
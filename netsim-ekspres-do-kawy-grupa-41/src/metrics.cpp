@@ -0,0 +1,27 @@
+#include "metrics.hpp"
+
+double NodeMetrics::utilization() const {
+    return observed_turns() > 0 ? static_cast<double>(busy_turns) / static_cast<double>(observed_turns()) : 0.0;
+}
+
+double NodeMetrics::mean_queue_length() const {
+    return observed_turns() > 0 ? static_cast<double>(queue_length_area) / static_cast<double>(observed_turns()) : 0.0;
+}
+
+#if defined(WITH_NODE_METRICS)
+void NodeMetricsRecorder::work_turn(Time t, bool busy, std::size_t queue_length, bool busy_after, std::size_t queue_length_after) {
+    if (last_turn_ != 0 and t > last_turn_ + 1) {
+        const Time skipped = t - last_turn_ - 1;
+        (busy_after_ ? metrics_.busy_turns : metrics_.idle_turns) += skipped;
+        metrics_.queue_length_area += queue_length_after_ * static_cast<std::uint64_t>(skipped);
+    }
+    (busy ? metrics_.busy_turns : metrics_.idle_turns) += 1;
+    metrics_.queue_length_area += queue_length;
+    if (queue_length > metrics_.max_queue_length) {
+        metrics_.max_queue_length = queue_length;
+    }
+    last_turn_ = t;
+    busy_after_ = busy_after;
+    queue_length_after_ = queue_length_after;
+}
+#endif
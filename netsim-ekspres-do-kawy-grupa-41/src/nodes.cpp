@@ -3,77 +3,190 @@
 //
 
 #include "nodes.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <typeinfo>
 #include <utility>
 
-#include <iostream>
 
+void ReceiverTable::add_receiver(IPackageReceiver* receiver, double weight) {
+    add_receiver_deferred(receiver, weight);
+    rebuild();
+}
+
+namespace {
+    ReceiverTable::ReceiverKey receiver_key(const IPackageReceiver* receiver) {
+        #if (defined EXERCISE_ID && EXERCISE_ID != EXERCISE_ID_NODES)
+            return {receiver->get_receiver_type(), receiver->get_id()};
+        #else
+            return {ReceiverType::WORKER, receiver->get_id()};
+        #endif
+    }
+}
 
-void ReceiverPreferences::add_receiver(IPackageReceiver* receiver) {
-    double n = static_cast<float>(preferences_.size());
-    double new_uniform = 1/(n + 1);
-    for(auto& pair: preferences_) {
-        pair.second = new_uniform;
+void ReceiverTable::add_receiver_deferred(IPackageReceiver* receiver, double weight) {
+    if (!(weight > 0)) {
+        throw std::invalid_argument("Waga odbiorcy musi byc dodatnia.");
+    }
+    auto [it, inserted] = weights_.try_emplace(receiver, weight);
+    it->second = weight;
+    if (inserted and observer_) {
+        observer_->link_added(sender_type_, sender_id_, receiver_key(receiver), receiver);
     }
-    preferences_.emplace(std::pair<IPackageReceiver*, double> (receiver, new_uniform));
 }
 
-void ReceiverPreferences::remove_receiver(IPackageReceiver* receiver) {
-    preferences_.erase(receiver);
-    double n = static_cast<float>(preferences_.size());
-    double new_uniform = 1/n;
-    for(auto& pair: preferences_){
-        pair.second = new_uniform;
+void ReceiverTable::remove_receiver(IPackageReceiver* receiver) {
+//    Usuniecie nieobecnego odbiorcy niczego nie zmienia - bez przebudowy tablicy aliasow
+    if (weights_.erase(receiver) == 0) {
+        return;
+    }
+    if (observer_) {
+        observer_->link_removed(sender_type_, sender_id_, receiver_key(receiver), receiver);
     }
+    rebuild();
 }
 
-IPackageReceiver* ReceiverPreferences::choose_receiver() const {
-    double num = rng_();
-    if (0 <= num and num <= 1) {
-        auto iter = preferences_.begin();
-        if(num <= iter->second){
-            return iter->first;
+void ReceiverTable::set_observer(LinkObserver* observer, SenderType sender_type, ElementID sender_id) {
+    observer_ = observer;
+    sender_type_ = sender_type;
+    sender_id_ = sender_id;
+    if (observer_) {
+        for (const auto& pair: weights_) {
+            observer_->link_added(sender_type_, sender_id_, receiver_key(pair.first), pair.first);
         }
-        auto prev_iter = iter;
-        iter++;
-        double p_left = 0;
-        double p_right = prev_iter->second;
-        for(; iter != preferences_.end(); iter++, prev_iter++){
-            p_left += prev_iter->second;
-            p_right += iter->second;
-            if (p_left <= num and num <= p_right){
-                return iter->first;
-            }
+    }
+}
+
+bool ReceiverTable::is_uniform() const {
+    return std::all_of(weights_.begin(), weights_.end(), [this](const auto& pair) { return pair.second == weights_.begin()->second; });
+}
+
+void ReceiverTable::rebuild() {
+    ++rebuilds_;
+    double total_weight = 0;
+    for (const auto& pair: weights_) {
+        total_weight += pair.second;
+    }
+    preferences_.clear();
+    receivers_.clear();
+    for (const auto& pair: weights_) {
+        preferences_.emplace(pair.first, pair.second / total_weight);
+        receivers_.push_back(pair.first);
+    }
+//    Kolejnosc kubelkow wg ID (a nie adresow w pamieci), zeby ta sama struktura wczytana ponownie
+//    dawala przy tym samym ciagu liczb losowych te same wybory
+    if (receivers_.size() > 1) {
+        std::stable_sort(receivers_.begin(), receivers_.end(), [](IPackageReceiver* a, IPackageReceiver* b) {
+            #if (defined EXERCISE_ID && EXERCISE_ID != EXERCISE_ID_NODES)
+                if (a->get_receiver_type() != b->get_receiver_type()) {
+                    return a->get_receiver_type() < b->get_receiver_type();
+                }
+            #endif
+            return a->get_id() < b->get_id();
+        });
+    }
+
+    receiver_keys_.clear();
+    for (auto receiver: receivers_) {
+        receiver_keys_.push_back(receiver_key(receiver));
+    }
+
+    std::size_t n = receivers_.size();
+    alias_probability_.assign(n, 1.0);
+    alias_.resize(n);
+    std::vector<double> scaled;
+    std::vector<std::size_t> small;
+    std::vector<std::size_t> large;
+    for (auto receiver: receivers_) {
+        scaled.push_back(weights_.at(receiver) * static_cast<double>(n) / total_weight);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        alias_[i] = i;
+        (scaled[i] < 1.0 ? small : large).push_back(i);
+    }
+    while (!small.empty() and !large.empty()) {
+        std::size_t s = small.back();
+        small.pop_back();
+        std::size_t l = large.back();
+        alias_probability_[s] = scaled[s];
+        alias_[s] = l;
+        scaled[l] -= 1.0 - scaled[s];
+        if (scaled[l] < 1.0) {
+            large.pop_back();
+            small.push_back(l);
         }
     }
+//    Pozostale kubelki (takze te z bledem zaokraglenia) wskazuja same na siebie z prawdopodobienstwem 1
+}
+
+IPackageReceiver* ReceiverTable::pick(double num) const {
+    if (0 <= num and num <= 1 and !receivers_.empty()) {
+        double scaled = num * static_cast<double>(receivers_.size());
+        auto i = std::min(static_cast<std::size_t>(scaled), receivers_.size() - 1);
+        return scaled - static_cast<double>(i) < alias_probability_[i] ? receivers_[i] : receivers_[alias_[i]];
+    }
     throw std::exception();
 }
 
-void PackageSender::send_package() {
+IPackageReceiver* PackageSender::send_package() {
     if (sending_buffer_) {
         auto picked_receiver = receiver_preferences_.choose_receiver();
-        picked_receiver->receive_package(std::move(sending_buffer_.value()));
-        sending_buffer_.reset();
+        send_package_to(picked_receiver);
+        return picked_receiver;
     }
+    return nullptr;
+}
+
+void PackageSender::send_package_to(IPackageReceiver* receiver) {
+    receiver->receive_package(std::move(sending_buffer_.value()));
+    sending_buffer_.reset();
+    metrics_.package_out();
 }
 
+Package PackageSender::release_sending_buffer() {
+    Package p = std::move(sending_buffer_.value());
+    sending_buffer_.reset();
+    metrics_.package_out();
+    return p;
+}
+
+
+Worker::queue_view_t Worker::resolve_queue(IPackageQueue* q) {
+    if (q != nullptr and typeid(*q) == typeid(PackageQueue)) {
+        return std::visit([](auto& static_queue) -> queue_view_t { return &static_queue; }, static_cast<PackageQueue*>(q)->get_static_queue());
+    }
+    return q;
+}
 
 void Worker::do_work(Time t) {
+    std::visit([this, t](auto* q) { do_work_on(*q, t); }, queue_view_);
+}
+
+template <class Queue>
+void Worker::do_work_on(Queue& q, Time t) {
     if (!processing_buffer_) {
-        if (!q_->empty()){
-            processing_buffer_.emplace(q_->pop());
+        if (!q.empty()){
+            processing_buffer_.emplace(q.pop());
             package_processing_start_time_ = t;
         }
     }
+    [[maybe_unused]] const bool busy = processing_buffer_.has_value();
+    [[maybe_unused]] const std::size_t waiting = node_metrics_enabled ? q.size() : 0;
     if (t - package_processing_start_time_ >= pd_ - 1 ) {
         if(processing_buffer_) {
             push_package(std::move(processing_buffer_.value()));
             processing_buffer_.reset();
         }
     }
+    if constexpr (node_metrics_enabled) {
+        metrics_.work_turn(t, busy, waiting, processing_buffer_.has_value(), q.size());
+    }
 }
 
 void Ramp::deliver_goods(Time t) {
-    if (!((t - 1) % di_)) {
-        sending_buffer_.emplace(Package());
+    if (is_delivery_due(t)) {
+        sending_buffer_.emplace(Package(*context_));
+        sending_buffer_->stamp_birth(t, id_);
+        metrics_.package_in(1);
     }
 }
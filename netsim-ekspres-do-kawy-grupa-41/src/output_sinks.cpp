@@ -0,0 +1,256 @@
+#include "output_sinks.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <ios>
+#include <iterator>
+#include <stdexcept>
+
+namespace {
+
+constexpr char columnar_magic[4] = {'N', 'S', 'C', 'O'};
+constexpr std::uint32_t columnar_version = 1;
+
+template <class T>
+void read_column(std::istream& is, std::vector<T>& column, std::size_t rows) {
+//    Liczba wierszy pochodzi z pliku - kolumna rosnie porcjami w miare odczytu, wiec uszkodzona liczba
+//    konczy sie bledem odczytu, a nie proba zajecia ogromnej pamieci
+    constexpr std::size_t chunk = 64 * 1024;
+    column.clear();
+    while (column.size() < rows) {
+        const std::size_t n = std::min(rows - column.size(), chunk);
+        column.resize(column.size() + n);
+        is.read(reinterpret_cast<char*>(column.data() + column.size() - n), static_cast<std::streamsize>(n * sizeof(T)));
+        if (!is) {
+            throw std::runtime_error("Niepelny blok wyjscia kolumnowego.");
+        }
+    }
+}
+
+}
+
+OutputFormat parse_output_format(std::string_view name) {
+    if (name == "jsonl") {
+        return OutputFormat::JSONL;
+    }
+    if (name == "csv") {
+        return OutputFormat::CSV;
+    }
+    if (name == "columnar") {
+        return OutputFormat::COLUMNAR;
+    }
+    throw std::invalid_argument("Nieznany format wyjscia: " + std::string(name));
+}
+
+TurnOutputSink::TurnOutputSink(std::ostream& os, std::size_t buffer_size) : os_(&os), buffer_size_(buffer_size) {
+    buffer_.reserve(buffer_size);
+}
+
+TurnOutputSink::~TurnOutputSink() {
+    try {
+        write_buffer();
+    } catch (const std::ios_base::failure&) {
+    }
+}
+
+void TurnOutputSink::append_number(long long value) {
+    char digits[24];
+    auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void TurnOutputSink::write_buffer() {
+    os_->write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    buffer_.clear();
+    if (!*os_) {
+        throw std::ios_base::failure("Nie mozna zapisac wyjscia symulacji.");
+    }
+}
+
+void TurnOutputSink::flush() {
+    write_buffer();
+}
+
+void TurnOutputSink::write(const Factory& f, Time t) {
+    order_.refresh(f);
+    begin_turn(t);
+    for (auto worker: order_.get_workers()) {
+        write_record({t, NodeKind::WORKER, worker->get_id(), static_cast<std::uint32_t>(worker->get_queue()->size()),
+                      worker->get_processing_buffer() ? worker->get_processing_buffer()->get_id() : -1,
+                      worker->get_sending_buffer() ? worker->get_sending_buffer()->get_id() : -1, 0});
+    }
+    for (auto storehouse: order_.get_storehouses()) {
+        write_record({t, NodeKind::STOREHOUSE, storehouse->get_id(), 0, -1, -1, storehouse->get_received_count()});
+    }
+    end_turn();
+    if (buffer_.size() >= buffer_size_) {
+        write_buffer();
+    }
+}
+
+void JsonLinesSink::begin_turn(Time t) {
+    append("{\"turn\":");
+    append_number(t);
+    append(",\"nodes\":[");
+    first_node_ = true;
+}
+
+void JsonLinesSink::append_id(ElementID id) {
+    if (id < 0) {
+        append("null");
+    } else {
+        append_number(id);
+    }
+}
+
+void JsonLinesSink::write_record(const NodeTurnRecord& record) {
+    append(first_node_ ? "{\"kind\":" : ",{\"kind\":");
+    first_node_ = false;
+    if (record.kind == NodeKind::WORKER) {
+        append("\"worker\",\"id\":");
+        append_number(record.id);
+        append(",\"queue\":");
+        append_number(record.queue_length);
+        append(",\"processing\":");
+        append_id(record.processing_id);
+        append(",\"sending\":");
+        append_id(record.sending_id);
+    } else {
+        append("\"storehouse\",\"id\":");
+        append_number(record.id);
+        append(",\"stock\":");
+        append_number(static_cast<long long>(record.stock_count));
+    }
+    append("}");
+}
+
+void JsonLinesSink::end_turn() {
+    append("]}\n");
+}
+
+CsvSink::CsvSink(std::ostream& os, std::size_t buffer_size) : TurnOutputSink(os, buffer_size) {
+    append("turn,kind,id,queue_length,processing_id,sending_id,stock_count\n");
+}
+
+void CsvSink::write_record(const NodeTurnRecord& record) {
+    append_number(record.turn);
+    if (record.kind == NodeKind::WORKER) {
+        append(",worker,");
+        append_number(record.id);
+        append(",");
+        append_number(record.queue_length);
+        append(",");
+        if (record.processing_id >= 0) {
+            append_number(record.processing_id);
+        }
+        append(",");
+        if (record.sending_id >= 0) {
+            append_number(record.sending_id);
+        }
+        append(",\n");
+    } else {
+        append(",storehouse,");
+        append_number(record.id);
+        append(",,,,");
+        append_number(static_cast<long long>(record.stock_count));
+        append("\n");
+    }
+}
+
+ColumnarSink::ColumnarSink(std::ostream& os, std::size_t block_rows)
+        : TurnOutputSink(os), block_rows_(block_rows == 0 ? 1 : block_rows) {
+    turns_.reserve(block_rows_);
+    kinds_.reserve(block_rows_);
+    ids_.reserve(block_rows_);
+    queue_lengths_.reserve(block_rows_);
+    processing_ids_.reserve(block_rows_);
+    sending_ids_.reserve(block_rows_);
+    stock_counts_.reserve(block_rows_);
+    append_bytes(columnar_magic, sizeof(columnar_magic));
+    append_bytes(&columnar_version, sizeof(columnar_version));
+}
+
+ColumnarSink::~ColumnarSink() {
+//    Zamkniecie ostatniego bloku - jak w klasie bazowej, bez zglaszania bledu zapisu
+    try {
+        flush();
+    } catch (const std::ios_base::failure&) {
+    }
+}
+
+void ColumnarSink::write_record(const NodeTurnRecord& record) {
+    turns_.push_back(record.turn);
+    kinds_.push_back(record.kind);
+    ids_.push_back(record.id);
+    queue_lengths_.push_back(record.queue_length);
+    processing_ids_.push_back(record.processing_id);
+    sending_ids_.push_back(record.sending_id);
+    stock_counts_.push_back(record.stock_count);
+    if (turns_.size() == block_rows_) {
+        flush();
+    }
+}
+
+void ColumnarSink::flush() {
+    if (!turns_.empty()) {
+        const auto rows = static_cast<std::uint32_t>(turns_.size());
+        append_bytes(&rows, sizeof(rows));
+        auto append_column = [this](auto& column) {
+            append_bytes(column.data(), column.size() * sizeof(column[0]));
+            column.clear();
+        };
+        append_column(turns_);
+        append_column(kinds_);
+        append_column(ids_);
+        append_column(queue_lengths_);
+        append_column(processing_ids_);
+        append_column(sending_ids_);
+        append_column(stock_counts_);
+    }
+    TurnOutputSink::flush();
+}
+
+std::unique_ptr<TurnOutputSink> make_output_sink(OutputFormat format, std::ostream& os) {
+    switch (format) {
+        case OutputFormat::JSONL:
+            return std::make_unique<JsonLinesSink>(os);
+        case OutputFormat::CSV:
+            return std::make_unique<CsvSink>(os);
+        case OutputFormat::COLUMNAR:
+            return std::make_unique<ColumnarSink>(os);
+    }
+    throw std::invalid_argument("Nieznany format wyjscia.");
+}
+
+std::vector<NodeTurnRecord> read_columnar_output(std::istream& is) {
+    char magic[sizeof(columnar_magic)];
+    std::uint32_t version = 0;
+    is.read(magic, sizeof(magic));
+    is.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!is or !std::equal(std::begin(magic), std::end(magic), std::begin(columnar_magic)) or version != columnar_version) {
+        throw std::runtime_error("To nie jest wyjscie kolumnowe symulacji.");
+    }
+
+    std::vector<NodeTurnRecord> records;
+    std::vector<std::int32_t> turns, ids, processing_ids, sending_ids;
+    std::vector<NodeKind> kinds;
+    std::vector<std::uint32_t> queue_lengths;
+    std::vector<std::uint64_t> stock_counts;
+    std::uint32_t rows = 0;
+    while (is.read(reinterpret_cast<char*>(&rows), sizeof(rows))) {
+        read_column(is, turns, rows);
+        read_column(is, kinds, rows);
+        read_column(is, ids, rows);
+        read_column(is, queue_lengths, rows);
+        read_column(is, processing_ids, rows);
+        read_column(is, sending_ids, rows);
+        read_column(is, stock_counts, rows);
+        for (std::size_t i = 0; i < rows; ++i) {
+            records.push_back({turns[i], kinds[i], ids[i], queue_lengths[i], processing_ids[i], sending_ids[i], stock_counts[i]});
+        }
+    }
+    if (is.gcount() != 0) {
+        throw std::runtime_error("Niepelny blok wyjscia kolumnowego.");
+    }
+    return records;
+}
@@ -5,41 +5,25 @@
 #include "package.hpp"
 
 Package & Package::operator=(Package&& other) noexcept {
-    this->ID_ = other.ID_;
-    other.ID_ = Package::invalid_id;
-    return *this;
-}
-
-Package::Package() {
-//    Jesli nie ma wolnych ID
-    if(Package::freed_IDs.empty()){
-        ElementID max_ID;
-//        Jesli sa przypisane jakies ID
-        if (!Package::assigned_IDs.empty()) {
-            max_ID = *Package::assigned_IDs.rbegin() + 1;
-            Package::assigned_IDs.insert(max_ID);
-            ID_ = max_ID;
-        }
-//        Jesli nie ma przypisanych zadnych ID
-        else {
-            max_ID = 1;
-            Package::assigned_IDs.insert(max_ID);
-            ID_ = max_ID;
+    if (this != &other) {
+        if (is_id_valid()) {
+            context_->id_allocator().release(ID_);
         }
+        this->ID_ = other.ID_;
+        this->context_ = other.context_;
+#if defined(WITH_PACKAGE_LATENCY)
+        this->birth_time_ = other.birth_time_;
+        this->origin_ = other.origin_;
+#endif
+        other.ID_ = Package::invalid_id;
     }
-//    Jesli są wolne ID
-    else{
-        auto iter = Package::freed_IDs.begin();
-        ElementID free_ID = *iter;
-        Package::freed_IDs.erase(iter);
-        Package::assigned_IDs.insert(free_ID);
-        ID_ = free_ID;
-    }
+    return *this;
 }
 
+Package::Package(SimulationContext& context) : ID_(context.id_allocator().allocate()), context_(&context) {}
+
 Package::~Package() {
     if (is_id_valid()) {
-        Package::assigned_IDs.erase(ID_);
-        Package::freed_IDs.insert(ID_);
+        context_->id_allocator().release(ID_);
     }
 }
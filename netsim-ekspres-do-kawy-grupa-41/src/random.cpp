@@ -0,0 +1,51 @@
+#include "random.hpp"
+
+namespace {
+
+constexpr std::uint32_t philox_m0 = 0xD2511F53;
+constexpr std::uint32_t philox_m1 = 0xCD9E8D57;
+constexpr std::uint32_t philox_w0 = 0x9E3779B9;
+constexpr std::uint32_t philox_w1 = 0xBB67AE85;
+
+// 53 najstarsze bity z dwoch slow -> liczba z [0, 1)
+double to_unit_double(std::uint32_t hi, std::uint32_t lo) {
+    return static_cast<double>(((static_cast<std::uint64_t>(hi) << 32) | lo) >> 11) * 0x1.0p-53;
+}
+
+}
+
+Philox4x32::counter_t Philox4x32::generate(counter_t counter, key_t key) {
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t product0 = static_cast<std::uint64_t>(philox_m0) * counter[0];
+        std::uint64_t product1 = static_cast<std::uint64_t>(philox_m1) * counter[2];
+        counter = {static_cast<std::uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                   static_cast<std::uint32_t>(product1),
+                   static_cast<std::uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                   static_cast<std::uint32_t>(product0)};
+        key[0] += philox_w0;
+        key[1] += philox_w1;
+    }
+    return counter;
+}
+
+RandomStream::RandomStream(std::uint64_t seed, std::uint64_t stream) : seed_(seed), stream_(stream) {}
+
+void RandomStream::seek(std::uint64_t position) {
+    batch_ = position / batch_size;
+    refill();
+    position_in_batch_ = static_cast<std::size_t>(position % batch_size);
+}
+
+void RandomStream::refill() {
+    const Philox4x32::key_t key = {static_cast<std::uint32_t>(seed_), static_cast<std::uint32_t>(seed_ >> 32)};
+//    Kazdy blok Philoxa (4 slowa) daje dwie liczby; licznik = (numer bloku, numer strumienia)
+    for (std::size_t block = 0; block < batch_size / 2; ++block) {
+        std::uint64_t index = batch_ * (batch_size / 2) + block;
+        auto words = Philox4x32::generate({static_cast<std::uint32_t>(index), static_cast<std::uint32_t>(index >> 32),
+                                           static_cast<std::uint32_t>(stream_), static_cast<std::uint32_t>(stream_ >> 32)}, key);
+        buffer_[2 * block] = to_unit_double(words[0], words[1]);
+        buffer_[2 * block + 1] = to_unit_double(words[2], words[3]);
+    }
+    batch_++;
+    position_in_batch_ = 0;
+}
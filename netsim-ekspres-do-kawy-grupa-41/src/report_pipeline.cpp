@@ -0,0 +1,87 @@
+#include "report_pipeline.hpp"
+
+#include <stdexcept>
+
+ReportPipeline::ReportPipeline(std::ostream& os, std::size_t slots) : os_(&os), slots_(slots) {
+    if (slots == 0) {
+        throw std::invalid_argument("Potok raportow wymaga co najmniej jednego zrzutu.");
+    }
+    writer_ = std::thread([this] { writer_loop(); });
+}
+
+ReportPipeline::~ReportPipeline() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    submitted_cv_.notify_one();
+    writer_.join();
+}
+
+void ReportPipeline::rethrow_error() {
+    if (error_) {
+        std::exception_ptr error = error_;
+        error_ = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ReportPipeline::submit(const Factory& f, Time t) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    rethrow_error();
+    if (submitted_ - written_ == slots_.size()) {
+        ++stalls_;
+        written_cv_.wait(lock, [this] { return submitted_ - written_ < slots_.size(); });
+    }
+//    Zrzut `submitted_` nie jest czytany przez pisarza, dopoki nie zostanie oddany
+    TurnSnapshot& slot = slots_[submitted_ % slots_.size()];
+    lock.unlock();
+    slot.capture(f, t);
+    lock.lock();
+    ++submitted_;
+    lock.unlock();
+    submitted_cv_.notify_one();
+}
+
+void ReportPipeline::drain() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    written_cv_.wait(lock, [this] { return written_ == submitted_; });
+    rethrow_error();
+}
+
+std::uint64_t ReportPipeline::get_stall_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stalls_;
+}
+
+void ReportPipeline::writer_loop() {
+    TurnReportWriter writer;
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        submitted_cv_.wait(lock, [this] { return stopping_ or written_ < submitted_; });
+        if (written_ == submitted_) {
+            return;
+        }
+        const TurnSnapshot& slot = slots_[written_ % slots_.size()];
+        const bool failed = static_cast<bool>(error_);
+        lock.unlock();
+//        Po bledzie zrzuty sa tylko zwalniane, zeby symulacja nie czekala w nieskonczonosc
+        std::exception_ptr error;
+        if (!failed) {
+            try {
+                writer.write(slot, *os_);
+                if (!*os_) {
+                    throw std::ios_base::failure("Nie mozna zapisac raportu tury.");
+                }
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        lock.lock();
+        if (error) {
+            error_ = error;
+        }
+        ++written_;
+        written_cv_.notify_all();
+    }
+}
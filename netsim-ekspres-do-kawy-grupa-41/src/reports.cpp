@@ -3,6 +3,12 @@
 //
 
 #include "reports.hpp"
+#include "retention.hpp"
+#include <algorithm>
+#include <charconv>
+#include <iomanip>
+#include <sstream>
+#include <iterator>
 #include <map>
 
 
@@ -128,72 +134,226 @@ void generate_structure_report(const Factory& f,std::ostream& os) {
 
 
 void generate_simulation_turn_report(const Factory& f,std::ostream& os,Time t) {
+    thread_local TurnReportWriter writer;
+    writer.write(f, os, t);
+}
 
-    std::vector<std::pair<ElementID , std::string>> mapping_worker;
-    for(auto it = f.worker_cbegin(); it != f.worker_cend(); it++){
+void NodeOrder::refresh(const Factory& f) {
+    if (factory_ == &f and topology_version_ == f.get_topology_version()) {
+        return;
+    }
+    workers_.clear();
+    storehouses_.clear();
+    for (auto it = f.worker_cbegin(); it != f.worker_cend(); it++) {
+        workers_.push_back(&*it);
+    }
+    for (auto it = f.storehouse_cbegin(); it != f.storehouse_cend(); it++) {
+        storehouses_.push_back(&*it);
+    }
+    std::sort(workers_.begin(), workers_.end(), [](auto a, auto b) { return a->get_id() < b->get_id(); });
+    std::sort(storehouses_.begin(), storehouses_.end(), [](auto a, auto b) { return a->get_id() < b->get_id(); });
+    factory_ = &f;
+    topology_version_ = f.get_topology_version();
+}
 
-        std::vector<std::pair<ElementID , std::string>> mapping_package;
-        bool pbuffer_has_val = it->get_processing_buffer().has_value();
-        bool sbuffer_has_val = it->get_sending_buffer().has_value();
-        bool queue_has_val = it->cbegin() != it->cend();
-
-        std::string pbuffer_stat = pbuffer_has_val ? "#" + std::to_string(it->get_processing_buffer().value().get_id()) +
-                                                     " (pt = " + std::to_string(t - it->get_package_processing_start_time() + 1) + ")" : "(empty)";
-        std::string sbuffer_stat = sbuffer_has_val ? "#" + std::to_string(it->get_sending_buffer().value().get_id()) : "(empty)";
-        std::string queue_stat;
-
-        if (queue_has_val){
-            auto it_package = it->cbegin();
-            queue_stat = "#" + std::to_string(it_package->get_id());
-            it_package++;
-            for(; it_package != it->cend(); it_package++){
-                queue_stat += ", #" + std::to_string(it_package->get_id());
-            }
-        } else {
-            queue_stat = "(empty)";
+void TurnSnapshot::capture(const Factory& f, Time t) {
+    order_.refresh(f);
+    turn_ = t;
+    worker_states_.clear();
+    storehouse_states_.clear();
+    ids_.clear();
+    for (auto worker: order_.get_workers()) {
+        WorkerState state{worker->get_id(), std::nullopt, 0, std::nullopt, ids_.size(), 0};
+        if (worker->get_processing_buffer()) {
+            state.processing = worker->get_processing_buffer()->get_id();
+            state.processing_time = t - worker->get_package_processing_start_time() + 1;
+        }
+        if (worker->get_sending_buffer()) {
+            state.sending = worker->get_sending_buffer()->get_id();
+        }
+        for (auto it = worker->cbegin(); it != worker->cend(); ++it) {
+            ids_.push_back(it->get_id());
+        }
+        state.queue_end = ids_.size();
+        worker_states_.push_back(state);
+    }
+    for (auto storehouse: order_.get_storehouses()) {
+        StorehouseState state{storehouse->get_id(), nullptr, 0, ids_.size(), 0};
+        if (auto retaining = dynamic_cast<const RetainingStockpile*>(storehouse->get_stockpile())) {
+            state.spill = retaining->get_spill_file();
+            state.spilled = storehouse->spilled_ids().size();
+        }
+        for (auto it = storehouse->cbegin(); it != storehouse->cend(); ++it) {
+            ids_.push_back(it->get_id());
         }
-        std::string message = "WORKER #" + std::to_string(it->get_id()) + "\n";
-        message += "  PBuffer: " + pbuffer_stat + "\n";
-        message += "  Queue: " + queue_stat + "\n";
-        message += "  SBuffer: " + sbuffer_stat + "\n\n";
-        mapping_worker.push_back(std::pair<ElementID, std::string>(it->get_id(), message));
+        state.stock_end = ids_.size();
+        storehouse_states_.push_back(state);
     }
+}
 
-    std::vector<std::pair<ElementID , std::string>> mapping_storehouse;
-    for(auto it = f.storehouse_cbegin(); it != f.storehouse_cend(); it++){
-        bool queue_has_val = it->cbegin() != it->cend();
-        std::string queue_stat;
-        if (queue_has_val){
-            auto it_package = it->cbegin();
-            queue_stat = "#" + std::to_string(it_package->get_id());
-            it_package++;
-            for(; it_package != it->cend(); it_package++){
-                queue_stat += ", #" + std::to_string(it_package->get_id());
-            }
+void TurnReportWriter::append_number(long long value) {
+    char digits[24];
+    auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+    buffer_.append(digits, result.ptr);
+}
+
+void TurnReportWriter::append_ids(const std::vector<ElementID>& ids, std::size_t begin, std::size_t end) {
+    if (begin == end) {
+        append("(empty)");
+        return;
+    }
+    for (std::size_t i = begin; i != end; ++i) {
+        append(i == begin ? "#" : ", #");
+        append_number(ids[i]);
+    }
+}
+
+void TurnReportWriter::append_stock(const TurnSnapshot::StorehouseState& storehouse, const std::vector<ElementID>& ids) {
+    if (storehouse.spilled == 0) {
+        append_ids(ids, storehouse.stock_begin, storehouse.stock_end);
+        return;
+    }
+//    ID z pliku czytane sa partiami - pamiec zapisu nie rosnie z wielkoscia magazynu
+    constexpr std::size_t chunk = 4096;
+    for (std::size_t first = 0; first < storehouse.spilled; first += chunk) {
+        spilled_.resize(std::min(chunk, storehouse.spilled - first));
+        storehouse.spill->read(first, spilled_.size(), spilled_.data());
+        for (std::size_t i = 0; i < spilled_.size(); ++i) {
+            append(first + i == 0 ? "#" : ", #");
+            append_number(spilled_[i]);
+        }
+    }
+    for (std::size_t i = storehouse.stock_begin; i != storehouse.stock_end; ++i) {
+        append(", #");
+        append_number(ids[i]);
+    }
+}
+
+void TurnReportWriter::write(const Factory& f, std::ostream& os, Time t) {
+    snapshot_.capture(f, t);
+    write(snapshot_, os);
+}
+
+void TurnReportWriter::write(const TurnSnapshot& snapshot, std::ostream& os) {
+    buffer_.clear();
+
+    append("=== [ Turn: ");
+    append_number(snapshot.get_turn());
+    append(" ] ===\n\n== WORKERS ==\n\n");
+    for (const auto& worker: snapshot.get_workers()) {
+        append("WORKER #");
+        append_number(worker.id);
+        append("\n  PBuffer: ");
+        if (worker.processing) {
+            append("#");
+            append_number(*worker.processing);
+            append(" (pt = ");
+            append_number(worker.processing_time);
+            append(")");
         } else {
-            queue_stat = "(empty)";
+            append("(empty)");
         }
-        std::string message = "STOREHOUSE #" + std::to_string(it->get_id()) + "\n";
-        message += "  Stock: " + queue_stat + "\n\n";
-        mapping_storehouse.push_back(std::pair<ElementID, std::string>(it->get_id(), message));
+        append("\n  Queue: ");
+        append_ids(snapshot.get_ids(), worker.queue_begin, worker.queue_end);
+        append("\n  SBuffer: ");
+        if (worker.sending) {
+            append("#");
+            append_number(*worker.sending);
+        } else {
+            append("(empty)");
+        }
+        append("\n\n");
+    }
+    append("\n== STOREHOUSES ==\n\n");
+    for (const auto& storehouse: snapshot.get_storehouses()) {
+        append("STOREHOUSE #");
+        append_number(storehouse.id);
+        append("\n  Stock: ");
+        append_stock(storehouse, snapshot.get_ids());
+        append("\n\n");
     }
 
-    std::sort(mapping_worker.begin(), mapping_worker.end(), []( auto& pair1, auto& pair2) { return pair1.first < pair2.first; });
-    std::sort(mapping_storehouse.begin(), mapping_storehouse.end(), []( auto& pair1, auto& pair2) { return pair1.first < pair2.first; });
+    os.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+}
 
-    os << "=== [ Turn: " + std::to_string(t)  + " ] ===" << std::endl;
-    os << std::endl;
-    os << "== WORKERS ==" << std::endl;
-    os << std::endl;
-    for(const auto& pair: mapping_worker){
-        os << pair.second;
+void generate_metrics_summary(const Factory& f, std::ostream& os) {
+    struct Row {
+        const char* kind;
+        ElementID id;
+        NodeMetrics metrics;
+    };
+    std::vector<Row> rows;
+    auto add_sorted = [&rows](const char* kind, auto begin, auto end) {
+        std::size_t first = rows.size();
+        for (auto it = begin; it != end; ++it) {
+            rows.push_back({kind, it->get_id(), it->get_metrics()});
+        }
+        std::sort(rows.begin() + static_cast<std::ptrdiff_t>(first), rows.end(), [](const Row& a, const Row& b) { return a.id < b.id; });
+    };
+    add_sorted("ramp", f.ramp_cbegin(), f.ramp_cend());
+    add_sorted("worker", f.worker_cbegin(), f.worker_cend());
+    add_sorted("storehouse", f.storehouse_cbegin(), f.storehouse_cend());
+
+    std::ostringstream table;
+    table << "== NODE METRICS ==\n\n"
+          << std::left << std::setw(12) << "node" << std::right << std::setw(8) << "id"
+          << std::setw(8) << "busy" << std::setw(8) << "idle" << std::setw(8) << "util%"
+          << std::setw(10) << "in" << std::setw(10) << "out" << std::setw(12) << "mean queue" << std::setw(11) << "max queue" << "\n";
+    table << std::fixed;
+    for (const auto& row: rows) {
+        const NodeMetrics& m = row.metrics;
+        table << std::left << std::setw(12) << row.kind << std::right << std::setw(8) << row.id
+              << std::setw(8) << m.busy_turns << std::setw(8) << m.idle_turns
+              << std::setw(8) << std::setprecision(1) << 100.0 * m.utilization()
+              << std::setw(10) << m.packages_in << std::setw(10) << m.packages_out
+              << std::setw(12) << std::setprecision(2) << m.mean_queue_length() << std::setw(11) << m.max_queue_length << "\n";
     }
-    os << std::endl;
-    os << "== STOREHOUSES ==" << std::endl;
-    os << std::endl;
-    for(const auto& pair: mapping_storehouse){
-        os << pair.second;
+    table << "\n";
+    os << table.str();
+}
+
+void generate_latency_summary(const Factory& f, std::ostream& os) {
+    std::vector<const Storehouse*> storehouses;
+    for (auto it = f.storehouse_cbegin(); it != f.storehouse_cend(); ++it) {
+        storehouses.push_back(&*it);
     }
+    std::sort(storehouses.begin(), storehouses.end(), [](const Storehouse* a, const Storehouse* b) { return a->get_id() < b->get_id(); });
+
+    std::ostringstream table;
+    table << "== PACKAGE LATENCY ==\n\n"
+          << std::left << std::setw(12) << "storehouse" << std::setw(10) << "path" << std::right
+          << std::setw(10) << "count" << std::setw(10) << "mean" << std::setw(8) << "p50" << std::setw(8) << "p99"
+          << std::setw(8) << "p999" << std::setw(8) << "max" << "\n";
+    table << std::fixed << std::setprecision(2);
+    auto add_row = [&table](ElementID storehouse, const std::string& path, const LatencyHistogram& h) {
+        table << std::left << std::setw(12) << storehouse << std::setw(10) << path << std::right
+              << std::setw(10) << h.count() << std::setw(10) << h.mean() << std::setw(8) << h.percentile(0.5)
+              << std::setw(8) << h.percentile(0.99) << std::setw(8) << h.percentile(0.999) << std::setw(8) << h.max() << "\n";
+    };
+    for (const Storehouse* storehouse: storehouses) {
+        const LatencyRecorder& latency = storehouse->get_latency();
+        add_row(storehouse->get_id(), "all", latency.get_total());
+        std::vector<ElementID> origins;
+        for (const auto& path: latency.get_paths()) {
+            origins.push_back(path.first);
+        }
+        std::sort(origins.begin(), origins.end());
+        for (ElementID origin: origins) {
+            add_row(storehouse->get_id(), "ramp-" + std::to_string(origin), latency.get_paths().at(origin));
+        }
+    }
+    table << "\n";
+    os << table.str();
+}
 
-    std::flush(os);
+void generate_fast_forward_report(const FastForwardSpan& span, std::ostream& os) {
+    os << "=== [ Turns: " << span.first_turn << "-" << span.last_turn << " (fast-forward) ] ===\n\n";
+    os << "Period: " << span.period << " turns x " << span.periods << "\n";
+    os << "Packages delivered: " << span.packages_delivered << "\n\n";
+    os << "== STOREHOUSES ==\n\n";
+    std::vector<std::pair<ElementID, std::uint64_t>> storehouses = span.storehouse_packages;
+    std::sort(storehouses.begin(), storehouses.end());
+    for (const auto& [id, received]: storehouses) {
+        os << "STOREHOUSE #" << id << "\n  Received: " << received << "\n\n";
+    }
 }
@@ -0,0 +1,151 @@
+#include "retention.hpp"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <iostream>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+PackageSpillFile::PackageSpillFile(const std::string& path) : path_(path) {
+    if (path.empty()) {
+        const char* dir = std::getenv("TMPDIR");
+        std::string name = std::string(dir && *dir ? dir : "/tmp") + "/net_simulation_spill_XXXXXX";
+        fd_ = ::mkstemp(name.data());
+        if (fd_ < 0) {
+            throw std::runtime_error("Nie mozna utworzyc pliku tymczasowego: " + name);
+        }
+        ::unlink(name.c_str());
+    } else {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) {
+            throw std::runtime_error("Nie mozna utworzyc pliku: " + path);
+        }
+    }
+}
+
+PackageSpillFile::~PackageSpillFile() {
+    unmap();
+    ::close(fd_);
+}
+
+void PackageSpillFile::append(const std::vector<ElementID>& ids) {
+    const char* bytes = reinterpret_cast<const char*>(ids.data());
+    std::size_t left = ids.size() * sizeof(ElementID);
+    while (left > 0) {
+        const ssize_t n = ::write(fd_, bytes, left);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Nie mozna zapisac pliku magazynu: " + (path_.empty() ? "(tymczasowy)" : path_));
+        }
+        bytes += n;
+        left -= static_cast<std::size_t>(n);
+    }
+    written_ += ids.size();
+    map(written_);
+}
+
+void PackageSpillFile::read(std::size_t first, std::size_t count, ElementID* out) const {
+    char* bytes = reinterpret_cast<char*>(out);
+    std::size_t left = count * sizeof(ElementID);
+    auto offset = static_cast<off_t>(first * sizeof(ElementID));
+    while (left > 0) {
+        const ssize_t n = ::pread(fd_, bytes, left, offset);
+        if (n <= 0) {
+            if (n < 0 and errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error("Nie mozna odczytac pliku magazynu: " + (path_.empty() ? "(tymczasowy)" : path_));
+        }
+        bytes += n;
+        left -= static_cast<std::size_t>(n);
+        offset += n;
+    }
+}
+
+void PackageSpillFile::unmap() {
+    if (data_ != nullptr) {
+        ::munmap(data_, mapped_ * sizeof(ElementID));
+        data_ = nullptr;
+        mapped_ = 0;
+    }
+}
+
+void PackageSpillFile::map(std::size_t size) {
+    unmap();
+    if (size == 0) {
+        return;
+    }
+    void* data = ::mmap(nullptr, size * sizeof(ElementID), PROT_READ, MAP_SHARED, fd_, 0);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Nie mozna odwzorowac pliku magazynu: " + (path_.empty() ? "(tymczasowy)" : path_));
+    }
+    data_ = data;
+    mapped_ = size;
+}
+
+RetainingStockpile::RetainingStockpile(RetentionPolicy policy, std::size_t keep, const std::string& spill_path)
+        : policy_(policy), keep_(policy == RetentionPolicy::COUNT_ONLY ? 0 : keep) {
+    if (policy == RetentionPolicy::SPILL) {
+        spill_ = std::make_shared<PackageSpillFile>(spill_path);
+        batch_.reserve(spill_batch_size);
+    }
+}
+
+RetainingStockpile::~RetainingStockpile() {
+//    Plik tymczasowy i tak zniknie razem z obiektem
+    if (spill_ and !spill_->get_path().empty()) {
+        try {
+            flush();
+        } catch (const std::runtime_error& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+}
+
+void RetainingStockpile::flush() {
+    if (spill_ and recent_.size() > keep_) {
+        spill(recent_.size() - keep_);
+    }
+}
+
+void RetainingStockpile::restore_spilled_ids(const std::vector<ElementID>& ids) {
+    if (!spill_) {
+        throw std::logic_error("Magazyn bez polityki SPILL nie ma pliku.");
+    }
+    spill_->append(ids);
+}
+
+void RetainingStockpile::push(Package&& package) {
+    ++received_;
+    if (spill_) {
+        recent_.push_back(std::move(package));
+        if (recent_.size() == keep_ + spill_batch_size) {
+            spill(spill_batch_size);
+        }
+        return;
+    }
+    if (recent_.size() == keep_) {
+        if (keep_ == 0) {
+            package.retire();
+            return;
+        }
+        recent_.pop_front().retire();
+    }
+    recent_.push_back(std::move(package));
+}
+
+void RetainingStockpile::spill(std::size_t count) {
+//    Polprodukty opuszczaja pamiec dopiero po udanym zapisie
+    batch_.clear();
+    for (auto it = recent_.cbegin(); batch_.size() < count; ++it) {
+        batch_.push_back(it->get_id());
+    }
+    spill_->append(batch_);
+    for (std::size_t i = 0; i < count; ++i) {
+        recent_.pop_front().retire();
+    }
+}
@@ -0,0 +1,54 @@
+#include "ring_buffer.hpp"
+
+#include <memory>
+#include <utility>
+
+PackageRingBuffer::PackageRingBuffer(PackageRingBuffer&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)), capacity_(std::exchange(other.capacity_, 0)),
+      head_(std::exchange(other.head_, 0)), size_(std::exchange(other.size_, 0)) {}
+
+PackageRingBuffer& PackageRingBuffer::operator=(PackageRingBuffer&& other) noexcept {
+    if (this != &other) {
+        clear();
+        data_ = std::exchange(other.data_, nullptr);
+        capacity_ = std::exchange(other.capacity_, 0);
+        head_ = std::exchange(other.head_, 0);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+PackageRingBuffer::~PackageRingBuffer() {
+    clear();
+}
+
+void PackageRingBuffer::grow() {
+    std::size_t new_capacity = capacity_ == 0 ? 16 : 2 * capacity_;
+    std::allocator<Package> allocator;
+    Package* new_data = allocator.allocate(new_capacity);
+//    Przeniesienie zawartosci tak, by kolejka zaczynala sie od poczatku nowej tablicy
+    for (std::size_t i = 0; i < size_; ++i) {
+        Package& old = data_[(head_ + i) & (capacity_ - 1)];
+        new (new_data + i) Package(std::move(old));
+        old.~Package();
+    }
+    if (data_) {
+        allocator.deallocate(data_, capacity_);
+    }
+    data_ = new_data;
+    capacity_ = new_capacity;
+    head_ = 0;
+}
+
+void PackageRingBuffer::clear() {
+    for (std::size_t i = 0; i < size_; ++i) {
+        data_[(head_ + i) & (capacity_ - 1)].~Package();
+    }
+    if (data_) {
+        std::allocator<Package>().deallocate(data_, capacity_);
+    }
+    data_ = nullptr;
+    capacity_ = 0;
+    head_ = 0;
+    size_ = 0;
+}
@@ -4,15 +4,250 @@
 
 #include "simulation.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+thread_local std::ostream* metrics_summary_output = nullptr;
+
+namespace {
+
+void dump_metrics_summary(const Factory& f) {
+    if (metrics_summary_output == nullptr) {
+        return;
+    }
+    if constexpr (node_metrics_enabled) {
+        generate_metrics_summary(f, *metrics_summary_output);
+    }
+    if constexpr (package_latency_enabled) {
+        generate_latency_summary(f, *metrics_summary_output);
+    }
+}
+
+}
+
 void simulate(Factory& f, TimeOffset d, std::function<void(Factory&, Time)> rf){
+    simulate_from(f, 1, d, std::move(rf));
+}
+
+void simulate_from(Factory& f, Time start, TimeOffset d, std::function<void(Factory&, Time)> rf){
     if (!f.is_consistent()) {
         throw std::logic_error("Siec nie jest spojna.");
     } else {
-        for (Time t = 1; t < d; t++) {
+        for (Time t = start; t < d; t++) {
             f.do_deliveries(t);
             f.do_package_passing();
             f.do_work(t);
             rf(f, t);
         }
     }
+    dump_metrics_summary(f);
+}
+
+void simulate_fast_forward(Factory& f, TimeOffset d, std::function<void(Factory&, Time)> rf,
+                           std::function<void(Factory&, const FastForwardSpan&)> on_skip) {
+    if (!f.is_consistent()) {
+        throw std::logic_error("Siec nie jest spojna.");
+    }
+    PeriodicFastForward fast_forward(f);
+    for (Time t = 1; t < d; t++) {
+        f.do_deliveries(t);
+        f.do_package_passing();
+        f.do_work(t);
+        rf(f, t);
+        if (TimeOffset period = fast_forward.observe(t)) {
+            const Time periods = (d - 1 - t) / period;
+            if (periods > 0) {
+                FastForwardSpan span = fast_forward.skip(t, periods);
+                t = span.last_turn;
+                if (on_skip) {
+                    on_skip(f, span);
+                }
+            }
+        }
+    }
+    dump_metrics_summary(f);
+}
+
+void simulate(Factory& f, TimeOffset d, std::function<void(Factory&, Time)> rf, ThreadPool& pool) {
+    if (!f.is_consistent()) {
+        throw std::logic_error("Siec nie jest spojna.");
+    }
+    for (Time t = 1; t < d; t++) {
+        f.do_deliveries(t, pool);
+        f.do_package_passing(pool);
+        f.do_work(t, pool);
+        rf(f, t);
+    }
+    dump_metrics_summary(f);
+}
+
+void simulate(CompiledFactory& f, TimeOffset d, std::function<void(Factory&, Time)> rf) {
+    if (f.is_stale()) {
+        throw std::logic_error("Uklad fabryki jest nieaktualny.");
+    }
+    f.sync_workers();
+    for (Time t = 1; t < d; t++) {
+        f.do_deliveries(t);
+        f.do_package_passing();
+        f.do_work(t);
+        rf(f.get_factory(), t);
+    }
+    dump_metrics_summary(f.get_factory());
+}
+
+namespace {
+
+enum class EventType {
+    DELIVERY,
+    WORK
+};
+
+struct Event {
+    Time t;
+    EventType type;
+    std::size_t index;
+
+    bool operator>(const Event& other) const {
+        return std::tie(t, type, index) > std::tie(other.t, other.type, other.index);
+    }
+};
+
+}
+
+void simulate_event_driven(Factory& f, TimeOffset d, std::function<void(Factory&, Time)> rf, ReportSchedule schedule) {
+    if (!f.is_consistent()) {
+        throw std::logic_error("Siec nie jest spojna.");
+    }
+
+    std::vector<Ramp*> ramps;
+    std::vector<Worker*> workers;
+    std::unordered_map<const IPackageReceiver*, std::size_t> worker_index;
+    for (auto it = f.ramp_begin(); it != f.ramp_end(); ++it) {
+        ramps.push_back(&*it);
+    }
+    for (auto it = f.worker_begin(); it != f.worker_end(); ++it) {
+        worker_index.emplace(&*it, workers.size());
+        workers.push_back(&*it);
+    }
+
+    std::priority_queue<Event, std::vector<Event>, std::greater<>> events;
+//    Nadawcy z pelnym buforem wysylkowym - w kolejnosci kolekcji, tak jak w Factory::do_package_passing()
+    std::vector<std::size_t> sending_ramps;
+    std::vector<std::size_t> sending_workers;
+    std::vector<std::size_t> working;
+
+    for (std::size_t i = 0; i < ramps.size(); ++i) {
+        events.push({1, EventType::DELIVERY, i});
+        if (ramps[i]->get_sending_buffer()) {
+            sending_ramps.push_back(i);
+        }
+    }
+//    Stan pozostawiony przez poprzednie wywolanie symulacji
+    for (std::size_t i = 0; i < workers.size(); ++i) {
+        const Worker& w = *workers[i];
+        if (w.get_sending_buffer()) {
+            sending_workers.push_back(i);
+        }
+        if (w.get_processing_buffer()) {
+            Time done = w.get_package_processing_start_time() + w.get_processing_duration() - 1;
+            events.push({std::max(done, 1), EventType::WORK, i});
+        } else if (w.has_queued_packages()) {
+            events.push({1, EventType::WORK, i});
+        }
+    }
+
+    auto report_until = [&](Time from, Time to) {
+        if (!schedule) {
+            for (Time t = from; t < to; ++t) {
+                rf(f, t);
+            }
+            return;
+        }
+        for (Time t = schedule(from); t < to; t = schedule(t + 1)) {
+            rf(f, t);
+        }
+    };
+
+    auto send = [&](PackageSender& sender) {
+        IPackageReceiver* receiver = sender.send_package();
+        auto found = worker_index.find(receiver);
+        if (found != worker_index.end() && !workers[found->second]->get_processing_buffer()) {
+            working.push_back(found->second);
+        }
+    };
+
+    Time t = 1;
+    Time last = 0;
+    while (t < d) {
+        f.get_context().set_turn(t);
+        while (!events.empty() && events.top().t == t) {
+            Event event = events.top();
+            events.pop();
+            if (event.type == EventType::DELIVERY) {
+                ramps[event.index]->deliver_goods(t);
+                events.push({t + ramps[event.index]->get_delivery_interval(), EventType::DELIVERY, event.index});
+                sending_ramps.push_back(event.index);
+            } else {
+                working.push_back(event.index);
+            }
+        }
+
+        std::sort(sending_ramps.begin(), sending_ramps.end());
+        for (auto i: sending_ramps) {
+            send(*ramps[i]);
+        }
+        sending_ramps.clear();
+        std::sort(sending_workers.begin(), sending_workers.end());
+        for (auto i: sending_workers) {
+            send(*workers[i]);
+        }
+        sending_workers.clear();
+
+        std::sort(working.begin(), working.end());
+        working.erase(std::unique(working.begin(), working.end()), working.end());
+        for (auto i: working) {
+            Worker& w = *workers[i];
+            w.do_work(t);
+            if (w.get_processing_buffer()) {
+                if (w.get_package_processing_start_time() == t) {
+                    events.push({t + w.get_processing_duration() - 1, EventType::WORK, i});
+                }
+            } else if (w.has_queued_packages()) {
+                events.push({t + 1, EventType::WORK, i});
+            }
+            if (w.get_sending_buffer()) {
+                sending_workers.push_back(i);
+            }
+        }
+        if constexpr (node_metrics_enabled) {
+//            Pozostali robotnicy nic w tej turze nie zrobia, ale ich tura musi trafic do metryk
+            for (std::size_t i = 0; i < workers.size(); ++i) {
+                if (!std::binary_search(working.begin(), working.end(), i)) {
+                    workers[i]->do_work(t);
+                }
+            }
+        }
+        working.clear();
+
+        Time next = events.empty() ? std::numeric_limits<Time>::max() : events.top().t;
+        if (!sending_workers.empty()) {
+            next = t + 1;
+        }
+        report_until(t, std::min(next, d));
+        last = t;
+        t = next;
+    }
+    if constexpr (node_metrics_enabled) {
+//        Po ostatnim zdarzeniu stan robotnikow juz sie nie zmienia - tury do d - 1 trzeba jeszcze doliczyc
+        if (last + 1 < d) {
+            for (Worker* w: workers) {
+                w->do_work(d - 1);
+            }
+        }
+    }
+    dump_metrics_summary(f);
 }
@@ -0,0 +1,6 @@
+#include "simulation_context.hpp"
+
+SimulationContext& SimulationContext::default_context() {
+    thread_local SimulationContext context;
+    return context;
+}
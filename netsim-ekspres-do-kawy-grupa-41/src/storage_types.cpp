@@ -3,24 +3,14 @@
 //
 
 #include "storage_types.hpp"
-#include <iostream>
 
-Package PackageQueue::pop() {
-
-    Package output;
-    switch (pqtype_) {
+PackageQueue::PackageQueue(PackageQueueType pqtype) : pqtype_(pqtype) {
+    switch (pqtype) {
         case PackageQueueType::FIFO:
-            Package::assigned_IDs.erase(que_.begin()->get_id());
-            Package::freed_IDs.insert(que_.begin()->get_id());
-            output = std::move(*que_.begin());
-            que_.pop_front();
+            que_.emplace<FifoQueue>();
             break;
         case PackageQueueType::LIFO:
-            Package::assigned_IDs.erase(que_.rbegin()->get_id());
-            Package::freed_IDs.insert(que_.rbegin()->get_id());
-            output = std::move(*que_.rbegin());
-            que_.pop_back();
+            que_.emplace<LifoQueue>();
             break;
     }
-    return output;
-}
\ No newline at end of file
+}
@@ -0,0 +1,271 @@
+#include "structure_parser.hpp"
+
+#include <charconv>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+// Plik odwzorowany w pamieci tylko do odczytu
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Nie mozna otworzyc pliku: " + path);
+        }
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Nie mozna odczytac pliku: " + path);
+        }
+        size_ = static_cast<std::size_t>(info.st_size);
+        if (size_ > 0) {
+            data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data_ == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("Nie mozna odwzorowac pliku: " + path);
+            }
+            ::madvise(data_, size_, MADV_SEQUENTIAL);
+        }
+        ::close(fd);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() {
+        if (size_ > 0) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    std::string_view view() const { return size_ > 0 ? std::string_view(static_cast<const char*>(data_), size_) : std::string_view(); }
+
+private:
+    void* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+class StructureParser {
+public:
+    explicit StructureParser(Factory& factory) : factory_(factory) {}
+
+    void parse_line(std::string_view line, std::size_t number) {
+        line_number_ = number;
+        std::string_view tag = next_token(line);
+        if (tag.empty() or tag.front() == ';') {
+            return;
+        }
+        if (tag == "LOADING_RAMP") {
+            parse_ramp(line);
+        } else if (tag == "WORKER") {
+            parse_worker(line);
+        } else if (tag == "STOREHOUSE") {
+            parse_storehouse(line);
+        } else if (tag == "LINK") {
+            parse_link(line);
+        } else {
+            fail("bledny identyfikator ElementType '" + std::string(tag) + "'");
+        }
+    }
+
+private:
+    [[noreturn]] void fail(const std::string& message) const { throw StructureParseError(line_number_, message); }
+
+    static std::string_view next_token(std::string_view& rest) {
+        std::size_t begin = rest.find_first_not_of(' ');
+        if (begin == std::string_view::npos) {
+            rest = {};
+            return {};
+        }
+        std::size_t end = rest.find(' ', begin);
+        std::string_view token = rest.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin);
+        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end);
+        return token;
+    }
+
+    // Kolejna para klucz=wartosc; false na koncu linii
+    bool next_parameter(std::string_view& rest, std::string_view& key, std::string_view& value) const {
+        std::string_view token = next_token(rest);
+        if (token.empty()) {
+            return false;
+        }
+        std::size_t eq = token.find('=');
+        if (eq == std::string_view::npos) {
+            fail("oczekiwano klucz=wartosc, jest '" + std::string(token) + "'");
+        }
+        key = token.substr(0, eq);
+        value = token.substr(eq + 1);
+        return true;
+    }
+
+    template <class Number>
+    Number to_number(std::string_view text) const {
+        Number value{};
+        auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (result.ec != std::errc() or result.ptr != text.data() + text.size()) {
+            fail("niepoprawna liczba '" + std::string(text) + "'");
+        }
+        return value;
+    }
+
+    void require(bool present, const char* key) const {
+        if (!present) {
+            fail(std::string("brak parametru ") + key);
+        }
+    }
+
+    void parse_ramp(std::string_view rest) {
+        std::string_view key, value;
+        ElementID id = 0;
+        TimeOffset delivery_interval = 0;
+        bool has_id = false, has_interval = false;
+        while (next_parameter(rest, key, value)) {
+            if (key == "id") {
+                id = to_number<ElementID>(value);
+                has_id = true;
+            } else if (key == "delivery-interval") {
+                delivery_interval = to_number<TimeOffset>(value);
+                has_interval = true;
+            }
+        }
+        require(has_id, "id");
+        require(has_interval, "delivery-interval");
+        factory_.add_ramp(Ramp(id, delivery_interval));
+    }
+
+    void parse_worker(std::string_view rest) {
+        std::string_view key, value;
+        ElementID id = 0;
+        TimeOffset processing_time = 0;
+        PackageQueueType queue_type = PackageQueueType::FIFO;
+        bool has_id = false, has_time = false, has_queue = false;
+        while (next_parameter(rest, key, value)) {
+            if (key == "id") {
+                id = to_number<ElementID>(value);
+                has_id = true;
+            } else if (key == "processing-time") {
+                processing_time = to_number<TimeOffset>(value);
+                has_time = true;
+            } else if (key == "queue-type") {
+                if (value == "FIFO") {
+                    queue_type = PackageQueueType::FIFO;
+                } else if (value == "LIFO") {
+                    queue_type = PackageQueueType::LIFO;
+                } else {
+                    fail("nieznany typ kolejki '" + std::string(value) + "'");
+                }
+                has_queue = true;
+            }
+        }
+        require(has_id, "id");
+        require(has_time, "processing-time");
+        require(has_queue, "queue-type");
+        factory_.add_worker(Worker(id, processing_time, std::make_unique<PackageQueue>(queue_type)));
+    }
+
+    void parse_storehouse(std::string_view rest) {
+        std::string_view key, value;
+        ElementID id = 0;
+        bool has_id = false;
+        while (next_parameter(rest, key, value)) {
+            if (key == "id") {
+                id = to_number<ElementID>(value);
+                has_id = true;
+            }
+        }
+        require(has_id, "id");
+        factory_.add_storehouse(Storehouse(id));
+    }
+
+    // "typ-id" -> (typ, id)
+    std::pair<std::string_view, ElementID> split_node(std::string_view value) const {
+        std::size_t dash = value.find('-');
+        if (dash == std::string_view::npos) {
+            fail("oczekiwano typ-id, jest '" + std::string(value) + "'");
+        }
+        return {value.substr(0, dash), to_number<ElementID>(value.substr(dash + 1))};
+    }
+
+    void parse_link(std::string_view rest) {
+        std::string_view key, value;
+        PackageSender* sender = nullptr;
+        IPackageReceiver* receiver = nullptr;
+        double weight = 1.0;
+        while (next_parameter(rest, key, value)) {
+            if (key == "src") {
+                auto [type, id] = split_node(value);
+                if (type == "ramp") {
+                    auto it = factory_.find_ramp_by_id(id);
+                    sender = it != factory_.ramp_end() ? &*it : nullptr;
+                } else if (type == "worker") {
+                    auto it = factory_.find_worker_by_id(id);
+                    sender = it != factory_.worker_end() ? &*it : nullptr;
+                } else {
+                    fail("nieznany typ nadawcy '" + std::string(type) + "'");
+                }
+                if (sender == nullptr) {
+                    fail("nieznany nadawca '" + std::string(value) + "'");
+                }
+            } else if (key == "dest") {
+                auto [type, id] = split_node(value);
+                if (type == "worker") {
+                    auto it = factory_.find_worker_by_id(id);
+                    receiver = it != factory_.worker_end() ? &*it : nullptr;
+                } else if (type == "store") {
+                    auto it = factory_.find_storehouse_by_id(id);
+                    receiver = it != factory_.storehouse_end() ? &*it : nullptr;
+                } else {
+                    fail("nieznany typ odbiorcy '" + std::string(type) + "'");
+                }
+                if (receiver == nullptr) {
+                    fail("nieznany odbiorca '" + std::string(value) + "'");
+                }
+            } else if (key == "p") {
+                weight = to_number<double>(value);
+            }
+        }
+        require(sender != nullptr, "src");
+        require(receiver != nullptr, "dest");
+        try {
+            sender->receiver_preferences_.add_receiver_deferred(receiver, weight);
+        } catch (const std::invalid_argument& e) {
+            fail(e.what());
+        }
+    }
+
+    Factory& factory_;
+    std::size_t line_number_ = 0;
+};
+
+}
+
+Factory parse_factory_structure(std::string_view text) {
+    Factory factory;
+    StructureParser parser(factory);
+    std::size_t number = 0;
+    while (!text.empty()) {
+        std::size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        if (!line.empty() and line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        parser.parse_line(line, ++number);
+    }
+//    Tablice aliasow budowane raz na nadawce, po wczytaniu wszystkich polaczen
+    for (auto it = factory.ramp_begin(); it != factory.ramp_end(); ++it) {
+        it->receiver_preferences_.rebuild();
+    }
+    for (auto it = factory.worker_begin(); it != factory.worker_end(); ++it) {
+        it->receiver_preferences_.rebuild();
+    }
+    return factory;
+}
+
+Factory load_factory_structure_file(const std::string& path) {
+    MappedFile file(path);
+    return parse_factory_structure(file.view());
+}
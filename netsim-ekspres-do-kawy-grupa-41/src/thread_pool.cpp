@@ -0,0 +1,90 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+ThreadPool::ThreadPool(std::size_t threads) {
+    for (std::size_t i = 1; i < std::max<std::size_t>(threads, 1); ++i) {
+        threads_.emplace_back([this]() { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    job_ready_.notify_all();
+    for (auto& thread: threads_) {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallel_for(std::size_t n, const body_t& body, std::size_t grain) {
+    if (n == 0) {
+        return;
+    }
+    if (grain == 0) {
+        grain = std::max<std::size_t>(1, n / (4 * size()));
+    }
+    if (threads_.empty() || n <= grain) {
+        body(0, n);
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        body_ = &body;
+        n_ = n;
+        grain_ = grain;
+        next_.store(0);
+        error_ = nullptr;
+        busy_ = threads_.size();
+        generation_++;
+    }
+    job_ready_.notify_all();
+    run_chunks();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_done_.wait(lock, [this]() { return busy_ == 0; });
+    body_ = nullptr;
+    if (error_) {
+        std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+}
+
+void ThreadPool::worker_loop() {
+    std::size_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_ready_.wait(lock, [&]() { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+        run_chunks();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            busy_--;
+        }
+        job_done_.notify_one();
+    }
+}
+
+void ThreadPool::run_chunks() {
+    while (true) {
+        std::size_t begin = next_.fetch_add(grain_);
+        if (begin >= n_) {
+            return;
+        }
+        try {
+            (*body_)(begin, std::min(begin + grain_, n_));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+}
@@ -0,0 +1,49 @@
+#include "worker_store.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+void WorkerStore::resize(std::size_t size) {
+    start_time_.resize(size, 0);
+    processing_duration_.resize(size, 1);
+    busy_.resize(size, 0);
+    processing_package_.resize(size, no_package);
+    sending_package_.resize(size, no_package);
+}
+
+void WorkerStore::load(std::size_t index, const Worker& worker) {
+    const auto& processing = worker.get_processing_buffer();
+    const auto& sending = worker.get_sending_buffer();
+//    Czas rozpoczecia wolnego robotnika nie ma znaczenia (i moze byc nieustalony)
+    start_time_[index] = processing ? worker.get_package_processing_start_time() : 0;
+    processing_duration_[index] = worker.get_processing_duration();
+    busy_[index] = processing.has_value();
+    processing_package_[index] = processing ? processing->get_id() : no_package;
+    sending_package_[index] = sending ? sending->get_id() : no_package;
+}
+
+void WorkerStore::mark_finished(Time t, std::uint8_t* finished) const {
+    const std::size_t n = size();
+    std::size_t i = 0;
+#if defined(__SSE2__)
+//    16 robotnikow naraz: t - start > pd - 2 dla czterech czworek int32, zwezone do bajtow i przyciete flaga zajetosci
+    const __m128i turn = _mm_set1_epi32(t);
+    const __m128i two = _mm_set1_epi32(2);
+    auto finished_quad = [&](std::size_t k) {
+        __m128i start = _mm_loadu_si128(reinterpret_cast<const __m128i*>(start_time_.data() + k));
+        __m128i duration = _mm_loadu_si128(reinterpret_cast<const __m128i*>(processing_duration_.data() + k));
+        return _mm_cmpgt_epi32(_mm_sub_epi32(turn, start), _mm_sub_epi32(duration, two));
+    };
+    for (; i + 16 <= n; i += 16) {
+        __m128i low = _mm_packs_epi32(finished_quad(i), finished_quad(i + 4));
+        __m128i high = _mm_packs_epi32(finished_quad(i + 8), finished_quad(i + 12));
+        __m128i mask = _mm_packs_epi16(low, high);
+        __m128i busy = _mm_loadu_si128(reinterpret_cast<const __m128i*>(busy_.data() + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(finished + i), _mm_and_si128(mask, busy));
+    }
+#endif
+    for (; i < n; ++i) {
+        finished[i] = static_cast<std::uint8_t>(busy_[i] & (t - start_time_[i] >= processing_duration_[i] - 1));
+    }
+}
@@ -4,6 +4,11 @@
 #include "factory.hpp"
 #include "nodes.hpp"
 
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
 // DEBUG
 #include <iostream>
 
@@ -68,6 +73,191 @@ TEST(FactoryTest, IsConsistentMissingLink2) {
     EXPECT_FALSE(factory.is_consistent());
 }
 
+TEST(FactoryTest, ConsistencyReportListsOffenders) {
+    // R1 -> W1 -> S, W1 -> W2 <-> W3 (W2 i W3 nie maja wyjscia do magazynu)
+    // R2 bez odbiorcow, W4 -> W4 nie jest zasilany przez zadna rampe
+
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_ramp(Ramp(2, 1));
+    for (ElementID id = 1; id <= 4; ++id) {
+        factory.add_worker(Worker(id, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    }
+    factory.add_storehouse(Storehouse(1));
+    auto worker = [&factory](ElementID id) { return &*factory.find_worker_by_id(id); };
+
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(worker(1));
+    worker(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    worker(1)->receiver_preferences_.add_receiver(worker(2));
+    worker(2)->receiver_preferences_.add_receiver(worker(3));
+    worker(3)->receiver_preferences_.add_receiver(worker(2));
+    worker(4)->receiver_preferences_.add_receiver(worker(4));
+
+    ConsistencyReport report = factory.check_consistency();
+
+    EXPECT_FALSE(report.consistent);
+    EXPECT_EQ(report.offending_ramps, std::vector<ElementID>{2});
+    EXPECT_EQ(report.offending_workers, (std::vector<ElementID>{2, 3}));
+}
+
+TEST(FactoryTest, ConsistencyWithNegativeWorkerIds) {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_worker(Worker(-5, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_worker(Worker(2, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_storehouse(Storehouse(1));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(-5));
+    factory.find_worker_by_id(-5)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(2));
+    factory.find_worker_by_id(2)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+
+    EXPECT_TRUE(factory.check_consistency().consistent);
+    EXPECT_TRUE(factory.is_consistent());
+}
+
+TEST(FactoryTest, LinkOutsideFactoryIsInconsistent) {
+    Worker outside(7, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_storehouse(Storehouse(1));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&outside);
+
+    EXPECT_THROW(factory.check_consistency(), std::logic_error);
+    EXPECT_FALSE(factory.is_consistent());
+}
+
+TEST(FactoryTest, LinkToOutsideNodeWithTrackedIdIsInconsistent) {
+    // Obcy robotnik i magazyn maja ID wezlow fabryki - o przynaleznosci decyduje adres, nie ID
+    Worker outside_worker(1, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    Storehouse outside_storehouse(1);
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_worker(Worker(1, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_storehouse(Storehouse(1));
+    factory.find_worker_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&outside_worker);
+    EXPECT_FALSE(factory.is_consistent());
+    EXPECT_THROW(factory.check_consistency(), std::logic_error);
+
+    factory.find_ramp_by_id(1)->receiver_preferences_.remove_receiver(&outside_worker);
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&outside_storehouse);
+    EXPECT_FALSE(factory.is_consistent());
+
+    factory.find_ramp_by_id(1)->receiver_preferences_.remove_receiver(&outside_storehouse);
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1));
+    EXPECT_TRUE(factory.is_consistent());
+    EXPECT_TRUE(factory.check_consistency().consistent);
+}
+
+TEST(FactoryTest, ConsistencyTrackingRecoversAfterDuplicateRemoval) {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_worker(Worker(1, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_worker(Worker(1, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_worker(Worker(2, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_storehouse(Storehouse(1));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(2));
+    factory.find_worker_by_id(2)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    EXPECT_FALSE(factory.has_exact_tracking());
+
+    factory.remove_worker(1);
+    EXPECT_TRUE(factory.has_exact_tracking());
+    EXPECT_TRUE(factory.is_consistent());
+
+    factory.find_worker_by_id(2)->receiver_preferences_.remove_receiver(&*factory.find_storehouse_by_id(1));
+    EXPECT_TRUE(factory.has_exact_tracking());
+    EXPECT_FALSE(factory.is_consistent());
+}
+
+TEST(FactoryTest, IsConsistentOnDeepChain) {
+    // R -> W1 -> W2 -> ... -> Wn -> S - rekurencyjne przejscie przepelniloby stos
+    const ElementID n = 200000;
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    for (ElementID id = 1; id <= n; ++id) {
+        factory.add_worker(Worker(id, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    }
+    factory.add_storehouse(Storehouse(1));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1));
+    for (ElementID id = 1; id < n; ++id) {
+        factory.find_worker_by_id(id)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(id + 1));
+    }
+    factory.find_worker_by_id(n)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+
+    EXPECT_TRUE(factory.is_consistent());
+
+    factory.remove_storehouse(1);
+    EXPECT_EQ(factory.check_consistency().offending_workers.size(), static_cast<std::size_t>(n));
+}
+
+TEST(FactoryTest, IsConsistentFollowsEdits) {
+    // R -> W1 -> S1, potem kolejne zmiany sieci miedzy sprawdzeniami
+
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_worker(Worker(1, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_storehouse(Storehouse(1));
+    auto worker = [&factory](ElementID id) { return &*factory.find_worker_by_id(id); };
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(worker(1));
+    worker(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    EXPECT_TRUE(factory.is_consistent());
+
+    factory.add_worker(Worker(2, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    worker(1)->receiver_preferences_.add_receiver(worker(2));
+    EXPECT_FALSE(factory.is_consistent());
+
+    worker(2)->receiver_preferences_.add_receiver(worker(1));
+    EXPECT_TRUE(factory.is_consistent());
+
+    factory.remove_storehouse(1);
+    EXPECT_FALSE(factory.is_consistent());
+
+    factory.add_storehouse(Storehouse(2));
+    worker(2)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(2));
+    EXPECT_TRUE(factory.is_consistent());
+
+    factory.remove_worker(2);
+    EXPECT_FALSE(factory.is_consistent());
+
+    factory.remove_ramp(1);
+    EXPECT_TRUE(factory.is_consistent());
+}
+
+TEST(FactoryTest, IsConsistentMatchesFullCheckAfterRandomEdits) {
+    Factory factory;
+    std::uint64_t lcg = 7;
+    auto next = [&lcg](std::uint64_t bound) {
+        lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<ElementID>((lcg >> 33) % bound) + 1;
+    };
+    for (int step = 0; step < 3000; ++step) {
+        ElementID a = next(12);
+        ElementID b = next(12);
+        auto sender = factory.find_worker_by_id(a);
+        auto worker = factory.find_worker_by_id(b);
+        auto storehouse = factory.find_storehouse_by_id(b % 3);
+        auto ramp = factory.find_ramp_by_id(a % 3);
+        switch (next(9)) {
+            case 1: if (sender == factory.worker_end()) factory.add_worker(Worker(a, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO))); break;
+            case 2: factory.remove_worker(a); break;
+            case 3: if (storehouse == factory.storehouse_end()) factory.add_storehouse(Storehouse(b % 3)); else factory.remove_storehouse(b % 3); break;
+            case 4: if (ramp == factory.ramp_end()) factory.add_ramp(Ramp(a % 3, 1)); else factory.remove_ramp(a % 3); break;
+            case 5: case 6:
+                if (sender != factory.worker_end() and worker != factory.worker_end()) sender->receiver_preferences_.add_receiver(&*worker);
+                if (ramp != factory.ramp_end() and worker != factory.worker_end()) ramp->receiver_preferences_.add_receiver(&*worker);
+                break;
+            case 7:
+                if (sender != factory.worker_end() and storehouse != factory.storehouse_end()) sender->receiver_preferences_.add_receiver(&*storehouse);
+                break;
+            default:
+                if (sender != factory.worker_end() and worker != factory.worker_end()) sender->receiver_preferences_.remove_receiver(&*worker);
+                if (sender != factory.worker_end() and storehouse != factory.storehouse_end()) sender->receiver_preferences_.remove_receiver(&*storehouse);
+                break;
+        }
+        ASSERT_EQ(factory.is_consistent(), factory.check_consistency().consistent) << "krok " << step;
+    }
+}
+
 TEST(FactoryTest, RemoveWorkerNoSuchReceiver) {
     /* Próba usunięcia nieistniejącego odbiorcy - dopuszczalne. */
 
@@ -140,3 +330,107 @@ TEST(FactoryTest, RemoveWorkerTwoRemainingReceivers) {
     ASSERT_NE(it, prefs.end());
     EXPECT_DOUBLE_EQ(it->second, 1.0 / 2.0);
 }
+
+TEST(NodeCollectionTest, FindByIdAfterRemoval) {
+    NodeCollection<Storehouse> collection;
+    for (ElementID id = 1; id <= 5; ++id) {
+        collection.add(Storehouse(id));
+    }
+    const Storehouse* s4 = &*collection.find_by_id(4);
+
+    collection.remove_by_id(2);
+    collection.remove_by_id(7);
+
+    EXPECT_EQ(collection.find_by_id(2), collection.end());
+    ASSERT_NE(collection.find_by_id(4), collection.end());
+    // Usuniecie innego wezla nie moze przesunac pozostalych w pamieci.
+    EXPECT_EQ(&*collection.find_by_id(4), s4);
+    EXPECT_EQ(collection.size(), 4U);
+
+    collection.add(Storehouse(2));
+    ASSERT_NE(collection.find_by_id(2), collection.end());
+    EXPECT_EQ(collection.find_by_id(2)->get_id(), 2);
+}
+
+namespace {
+
+// R -> W -> S, rampa dostarcza w kazdej turze
+Factory make_line_factory() {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_worker(Worker(1, 2, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_storehouse(Storehouse(1));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1));
+    factory.find_worker_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    return factory;
+}
+
+std::vector<ElementID> run_line_factory(Factory& factory, Time turns) {
+    for (Time t = 1; t <= turns; ++t) {
+        factory.do_deliveries(t);
+        factory.do_package_passing();
+        factory.do_work(t);
+    }
+    std::vector<ElementID> stored;
+    auto storehouse = factory.find_storehouse_by_id(1);
+    for (auto it = storehouse->cbegin(); it != storehouse->cend(); ++it) {
+        stored.push_back(it->get_id());
+    }
+    return stored;
+}
+
+}
+
+TEST(FactoryTest, FactoriesHaveSeparatePackageIds) {
+    Factory first = make_line_factory();
+    Factory second = make_line_factory();
+
+    first.do_deliveries(1);
+    second.do_deliveries(1);
+
+    EXPECT_EQ(first.find_ramp_by_id(1)->get_sending_buffer()->get_id(), 1);
+    EXPECT_EQ(second.find_ramp_by_id(1)->get_sending_buffer()->get_id(), 1);
+}
+
+TEST(FactoryTest, FactoriesSimulateOnSeparateThreads) {
+    Factory reference = make_line_factory();
+    std::vector<ElementID> expected = run_line_factory(reference, 100);
+
+    std::vector<Factory> factories;
+    for (int i = 0; i < 4; ++i) {
+        factories.push_back(make_line_factory());
+    }
+    std::vector<std::vector<ElementID>> results(factories.size());
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < factories.size(); ++i) {
+        threads.emplace_back([&factories, &results, i]() { results[i] = run_line_factory(factories[i], 100); });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+
+    for (const auto& result: results) {
+        EXPECT_EQ(result, expected);
+    }
+}
+
+TEST(FactoryTest, MovedFromFactoryStaysUsable) {
+    Factory source = make_line_factory();
+    Factory constructed(std::move(source));
+    EXPECT_TRUE(source.is_consistent());
+    EXPECT_TRUE(constructed.is_consistent());
+    source.add_ramp(Ramp(1, 1));
+    source.do_deliveries(1);
+    EXPECT_EQ(source.find_ramp_by_id(1)->get_sending_buffer()->get_id(), 1);
+    EXPECT_NE(&source.get_context(), &constructed.get_context());
+
+    Factory assigned;
+    assigned = std::move(source);
+    EXPECT_TRUE(source.is_consistent());
+    source.add_ramp(Ramp(2, 1));
+    source.do_deliveries(1);
+    EXPECT_EQ(source.find_ramp_by_id(2)->get_sending_buffer()->get_id(), 1);
+    EXPECT_EQ(assigned.find_ramp_by_id(1)->get_sending_buffer()->get_id(), 1);
+    EXPECT_FALSE(source.is_consistent());
+    EXPECT_FALSE(assigned.is_consistent());
+}
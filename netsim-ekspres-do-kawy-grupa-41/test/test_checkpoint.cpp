@@ -0,0 +1,218 @@
+#include "gtest/gtest.h"
+
+#include "checkpoint.hpp"
+#include "helpers.hpp"
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+const char* checkpoint_test_structure =
+        "LOADING_RAMP id=1 delivery-interval=2\n"
+        "LOADING_RAMP id=2 delivery-interval=5\n"
+        "WORKER id=1 processing-time=3 queue-type=FIFO\n"
+        "WORKER id=2 processing-time=2 queue-type=LIFO\n"
+        "WORKER id=3 processing-time=4 queue-type=FIFO\n"
+        "STOREHOUSE id=1\n"
+        "STOREHOUSE id=2\n"
+        "LINK src=ramp-1 dest=worker-1\n"
+        "LINK src=ramp-1 dest=worker-2 p=3\n"
+        "LINK src=ramp-2 dest=worker-3\n"
+        "LINK src=worker-1 dest=worker-2\n"
+        "LINK src=worker-1 dest=store-1\n"
+        "LINK src=worker-2 dest=store-2\n"
+        "LINK src=worker-2 dest=worker-3\n"
+        "LINK src=worker-3 dest=store-1\n"
+        "LINK src=worker-3 dest=worker-1\n";
+
+auto report_to(std::ostringstream& os) {
+    return [&os](Factory& f, Time t) { generate_simulation_turn_report(f, os, t); };
+}
+
+// Symulacja przerwana po turze 60 i wznowiona z punktu kontrolnego musi dac te same raporty co symulacja ciagla.
+void expect_resume_matches(bool seeded) {
+    seed_rng(17);
+    std::istringstream iss(checkpoint_test_structure);
+    Factory factory = load_factory_structure(iss);
+    if (seeded) {
+        factory.seed_streams(4);
+    }
+    simulate_from(factory, 1, 61, [](Factory&, Time) {});
+
+    std::stringstream snapshot;
+    save_checkpoint(factory, 60, snapshot);
+
+    std::ostringstream expected;
+    simulate_from(factory, 61, 150, report_to(expected));
+
+    seed_rng(99);
+    Checkpoint restored = load_checkpoint(snapshot);
+    EXPECT_EQ(restored.turn, 60);
+    std::ostringstream actual;
+    simulate_from(restored.factory, restored.turn + 1, 150, report_to(actual));
+
+    EXPECT_EQ(actual.str(), expected.str());
+}
+
+// Rampa dostarczajaca w kazdej turze prosto do magazynu o podanej polityce przechowywania
+Factory make_retaining_factory(RetentionPolicy policy, std::size_t keep, const std::string& spill_path = "") {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_storehouse(Storehouse(1, std::make_unique<RetainingStockpile>(policy, keep, spill_path)));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    return factory;
+}
+
+const RetainingStockpile* retaining_stockpile(const Factory& factory) {
+    return dynamic_cast<const RetainingStockpile*>(factory.find_storehouse_by_id(1)->get_stockpile());
+}
+
+}
+
+TEST(CheckpointTest, ResumeWithNodeStreamsIsIdentical) {
+    expect_resume_matches(true);
+}
+
+TEST(CheckpointTest, ResumeWithGlobalGeneratorIsIdentical) {
+    expect_resume_matches(false);
+}
+
+TEST(CheckpointTest, RestoresStructureAndWeights) {
+    std::istringstream iss(checkpoint_test_structure);
+    Factory factory = load_factory_structure(iss);
+    std::stringstream snapshot;
+    save_checkpoint(factory, 0, snapshot);
+
+    Checkpoint restored = load_checkpoint(snapshot);
+
+    // Kolejnosc polaczen w zapisie zalezy od adresow wezlow, wiec porownywane sa posortowane linie
+    auto structure_lines = [](Factory& f) {
+        std::stringstream ss;
+        save_factory_structure(f, ss);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(ss, line);) {
+            lines.push_back(line);
+        }
+        std::sort(lines.begin(), lines.end());
+        return lines;
+    };
+    EXPECT_EQ(structure_lines(restored.factory), structure_lines(factory));
+    EXPECT_TRUE(restored.factory.is_consistent());
+}
+
+TEST(CheckpointTest, RejectsDamagedInput) {
+    std::istringstream iss(checkpoint_test_structure);
+    Factory factory = load_factory_structure(iss);
+    std::stringstream snapshot;
+    save_checkpoint(factory, 0, snapshot);
+    std::string data = snapshot.str();
+
+    std::istringstream truncated(data.substr(0, data.size() / 2));
+    EXPECT_THROW(load_checkpoint(truncated), std::runtime_error);
+
+    std::istringstream wrong_magic("XXXX" + data.substr(4));
+    EXPECT_THROW(load_checkpoint(wrong_magic), std::runtime_error);
+
+//    Liczba zwolnionych ID (po naglowku, turze i nastepnym ID) zamieniona na ogromna
+    std::string huge_count = data;
+    const std::uint64_t count = std::uint64_t{1} << 60;
+    huge_count.replace(16, sizeof(count), reinterpret_cast<const char*>(&count), sizeof(count));
+    std::istringstream damaged(huge_count);
+    EXPECT_THROW(load_checkpoint(damaged), std::runtime_error);
+}
+
+TEST(CheckpointTest, RejectsUnknownGenerator) {
+    std::istringstream iss(checkpoint_test_structure);
+    Factory factory = load_factory_structure(iss);
+    factory.find_ramp_by_id(1)->receiver_preferences_.set_generator([]() { return 0.5; });
+    std::stringstream snapshot;
+
+    EXPECT_THROW(save_checkpoint(factory, 0, snapshot), std::logic_error);
+}
+
+TEST(CheckpointTest, IdleWorkersSaveZeroStartTime) {
+//    Robotnik, ktory jeszcze nic nie przetwarzal, ma czas rozpoczecia 0 - zapis nie zalezy od zawartosci pamieci
+    std::istringstream iss(checkpoint_test_structure);
+    Factory factory = load_factory_structure(iss);
+    factory.seed_streams(4);
+    EXPECT_EQ(factory.find_worker_by_id(1)->get_package_processing_start_time(), 0);
+
+    std::stringstream snapshot;
+    save_checkpoint(factory, 0, snapshot);
+    Checkpoint restored = load_checkpoint(snapshot);
+    for (ElementID id = 1; id <= 3; ++id) {
+        EXPECT_EQ(restored.factory.find_worker_by_id(id)->get_package_processing_start_time(), 0);
+    }
+}
+
+TEST(CheckpointTest, KeepsCountOnlyRetention) {
+    Factory factory = make_retaining_factory(RetentionPolicy::COUNT_ONLY, 0);
+    simulate_from(factory, 1, 41, [](Factory&, Time) {});
+    std::stringstream snapshot;
+    save_checkpoint(factory, 40, snapshot);
+    simulate_from(factory, 41, 100, [](Factory&, Time) {});
+
+    Checkpoint restored = load_checkpoint(snapshot);
+    const RetainingStockpile* stockpile = retaining_stockpile(restored.factory);
+    ASSERT_NE(stockpile, nullptr);
+    EXPECT_EQ(stockpile->get_policy(), RetentionPolicy::COUNT_ONLY);
+    EXPECT_EQ(stockpile->received_count(), 40u);
+    EXPECT_TRUE(stockpile->empty());
+
+    simulate_from(restored.factory, restored.turn + 1, 100, [](Factory&, Time) {});
+    EXPECT_EQ(stockpile->received_count(), retaining_stockpile(factory)->received_count());
+    EXPECT_EQ(restored.factory.get_context().id_allocator().get_next_fresh_id(),
+              factory.get_context().id_allocator().get_next_fresh_id());
+}
+
+TEST(CheckpointTest, KeepsSpilledStock) {
+    const Time turn = static_cast<Time>(RetainingStockpile::spill_batch_size) + 200;
+    Factory factory = make_retaining_factory(RetentionPolicy::SPILL, 10);
+    simulate_from(factory, 1, turn + 1, [](Factory&, Time) {});
+    ASSERT_FALSE(factory.find_storehouse_by_id(1)->spilled_ids().empty());
+    std::stringstream snapshot;
+    save_checkpoint(factory, turn, snapshot);
+
+    std::ostringstream expected;
+    generate_simulation_turn_report(factory, expected, turn);
+    Checkpoint restored = load_checkpoint(snapshot);
+    std::ostringstream actual;
+    generate_simulation_turn_report(restored.factory, actual, turn);
+    EXPECT_EQ(actual.str(), expected.str());
+    EXPECT_EQ(retaining_stockpile(restored.factory)->get_keep(), 10u);
+    EXPECT_EQ(retaining_stockpile(restored.factory)->received_count(), retaining_stockpile(factory)->received_count());
+}
+
+TEST(CheckpointTest, RestoresNamedSpillIntoSeparateFile) {
+    const std::string path = ::testing::TempDir() + "net_simulation_checkpoint_spill.bin";
+    const Time turn = static_cast<Time>(RetainingStockpile::spill_batch_size) + 200;
+    {
+        Factory factory = make_retaining_factory(RetentionPolicy::SPILL, 10, path);
+        simulate_from(factory, 1, turn + 1, [](Factory&, Time) {});
+        const PackageIdRange spilled = factory.find_storehouse_by_id(1)->spilled_ids();
+        const std::vector<ElementID> expected(spilled.begin(), spilled.end());
+        ASSERT_FALSE(expected.empty());
+        std::stringstream snapshot;
+        save_checkpoint(factory, turn, snapshot);
+
+        Checkpoint restored = load_checkpoint(snapshot);
+        const PackageIdRange source_ids = factory.find_storehouse_by_id(1)->spilled_ids();
+        EXPECT_EQ(std::vector<ElementID>(source_ids.begin(), source_ids.end()), expected);
+        const PackageIdRange restored_ids = restored.factory.find_storehouse_by_id(1)->spilled_ids();
+        EXPECT_EQ(std::vector<ElementID>(restored_ids.begin(), restored_ids.end()), expected);
+        EXPECT_NE(retaining_stockpile(restored.factory)->get_spill_path(), path);
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        EXPECT_EQ(static_cast<std::size_t>(file.tellg()), expected.size() * sizeof(ElementID));
+    }
+    std::remove(path.c_str());
+}
@@ -0,0 +1,86 @@
+#include "gtest/gtest.h"
+
+#include "compiled_factory.hpp"
+#include "simulation.hpp"
+
+#include <memory>
+
+namespace {
+
+// R1 -> W2 -> S3, R1 -> W1 -> S3
+Factory make_factory() {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_worker(Worker(2, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_worker(Worker(1, 2, std::make_unique<PackageQueue>(PackageQueueType::LIFO)));
+    factory.add_storehouse(Storehouse(3));
+    auto& ramp = *factory.find_ramp_by_id(1);
+    ramp.receiver_preferences_.add_receiver(&*factory.find_worker_by_id(2));
+    ramp.receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1));
+    factory.find_worker_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(3));
+    factory.find_worker_by_id(2)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(3));
+    return factory;
+}
+
+}
+
+TEST(CompiledFactoryTest, IndicesMapToElementIds) {
+    Factory factory = make_factory();
+    CompiledFactory compiled(factory);
+
+    ASSERT_EQ(compiled.ramp_count(), 1u);
+    ASSERT_EQ(compiled.worker_count(), 2u);
+    ASSERT_EQ(compiled.storehouse_count(), 1u);
+    EXPECT_EQ(compiled.get_ramp_id(0), 1);
+    EXPECT_EQ(compiled.get_worker_id(0), 2);
+    EXPECT_EQ(compiled.get_worker_id(1), 1);
+    EXPECT_EQ(compiled.get_storehouse_id(0), 3);
+}
+
+TEST(CompiledFactoryTest, PassesPackagesToChosenReceiver) {
+    Factory factory = make_factory();
+    auto& ramp = *factory.find_ramp_by_id(1);
+    // Liczba bliska 1 wskazuje ostatniego odbiorce w kolejnosci ID - robotnika 2
+    ramp.receiver_preferences_.set_generator([]() { return 0.99; });
+    CompiledFactory compiled(factory);
+
+    compiled.do_deliveries(1);
+    compiled.do_package_passing();
+
+    const Worker& w2 = *factory.find_worker_by_id(2);
+    const Worker& w1 = *factory.find_worker_by_id(1);
+    EXPECT_NE(w2.cbegin(), w2.cend());
+    EXPECT_EQ(w1.cbegin(), w1.cend());
+    EXPECT_FALSE(ramp.get_sending_buffer().has_value());
+}
+
+TEST(CompiledFactoryTest, DetectsChangesAfterCompilation) {
+    Factory factory = make_factory();
+    CompiledFactory compiled(factory);
+    EXPECT_FALSE(compiled.is_stale());
+
+    factory.find_ramp_by_id(1)->receiver_preferences_.remove_receiver(&*factory.find_worker_by_id(1));
+    EXPECT_TRUE(compiled.is_stale());
+    EXPECT_THROW(simulate(compiled, 3, [](Factory&, Time) {}), std::logic_error);
+
+    CompiledFactory recompiled(factory);
+    EXPECT_FALSE(recompiled.is_stale());
+    factory.add_storehouse(Storehouse(4));
+    EXPECT_TRUE(recompiled.is_stale());
+}
+
+TEST(CompiledFactoryTest, DetectsWeightChangesAfterCompilation) {
+    Factory factory = make_factory();
+    CompiledFactory compiled(factory);
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1), 5.0);
+    EXPECT_TRUE(compiled.is_stale());
+    EXPECT_THROW(simulate(compiled, 3, [](Factory&, Time) {}), std::logic_error);
+    EXPECT_FALSE(CompiledFactory(factory).is_stale());
+}
+
+TEST(CompiledFactoryTest, RejectsInconsistentFactory) {
+    Factory factory = make_factory();
+    factory.remove_storehouse(3);
+
+    EXPECT_THROW(CompiledFactory compiled(factory), std::logic_error);
+}
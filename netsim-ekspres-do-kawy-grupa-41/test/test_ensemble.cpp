@@ -0,0 +1,81 @@
+#include "gtest/gtest.h"
+
+#include "ensemble.hpp"
+
+#include <string>
+
+namespace {
+
+const char* branching_structure =
+        "LOADING_RAMP id=1 delivery-interval=1\n"
+        "WORKER id=1 processing-time=1 queue-type=FIFO\n"
+        "WORKER id=2 processing-time=3 queue-type=LIFO\n"
+        "STOREHOUSE id=1\n"
+        "STOREHOUSE id=2\n"
+        "LINK src=ramp-1 dest=worker-1\n"
+        "LINK src=ramp-1 dest=worker-2\n"
+        "LINK src=worker-1 dest=store-1\n"
+        "LINK src=worker-1 dest=store-2\n"
+        "LINK src=worker-2 dest=store-2\n";
+
+}
+
+TEST(EnsembleTest, ResultsDoNotDependOnThreadCount) {
+    EnsembleOptions options;
+    options.turns = 50;
+    options.replicas = 16;
+    options.base_seed = 7;
+
+    ThreadPool sequential(1);
+    ThreadPool parallel(4);
+    auto expected = run_ensemble(branching_structure, options, sequential);
+    auto actual = run_ensemble(branching_structure, options, parallel);
+
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].type, expected[i].type);
+        EXPECT_EQ(actual[i].id, expected[i].id);
+        EXPECT_EQ(actual[i].mean, expected[i].mean);
+        EXPECT_EQ(actual[i].variance, expected[i].variance);
+    }
+}
+
+TEST(EnsembleTest, ReplicasDiffer) {
+    EnsembleOptions options;
+    options.turns = 50;
+    options.replicas = 16;
+    ThreadPool pool(2);
+
+    auto statistics = run_ensemble(branching_structure, options, pool);
+
+    ASSERT_EQ(statistics.size(), 4u);
+    EXPECT_EQ(statistics[0].type, ElementType::WORKER);
+    EXPECT_EQ(statistics[0].id, 1);
+    EXPECT_EQ(statistics[3].type, ElementType::STOREHOUSE);
+    EXPECT_EQ(statistics[3].id, 2);
+    for (const auto& node: statistics) {
+        EXPECT_LE(node.ci_low, node.mean);
+        EXPECT_GE(node.ci_high, node.mean);
+    }
+    EXPECT_GT(statistics[2].variance, 0.0);
+}
+
+TEST(EnsembleTest, DeterministicNetworkHasNoVariance) {
+    const char* structure =
+            "LOADING_RAMP id=1 delivery-interval=2\n"
+            "WORKER id=1 processing-time=1 queue-type=FIFO\n"
+            "STOREHOUSE id=1\n"
+            "LINK src=ramp-1 dest=worker-1\n"
+            "LINK src=worker-1 dest=store-1\n";
+    EnsembleOptions options;
+    options.turns = 11;
+    options.replicas = 5;
+    ThreadPool pool(2);
+
+    auto statistics = run_ensemble(structure, options, pool);
+
+    ASSERT_EQ(statistics.size(), 2u);
+    EXPECT_EQ(statistics[1].mean, 5.0);
+    EXPECT_EQ(statistics[1].variance, 0.0);
+    EXPECT_EQ(statistics[1].ci_low, statistics[1].ci_high);
+}
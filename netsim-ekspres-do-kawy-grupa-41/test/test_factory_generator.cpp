@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+
+#include "factory_generator.hpp"
+#include "reports.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+std::string structure_report(const Factory& factory) {
+    std::ostringstream oss;
+    generate_structure_report(factory, oss);
+    return oss.str();
+}
+
+}
+
+TEST(FactoryGeneratorTest, GeneratedFactoriesAreConsistent) {
+    for (std::uint64_t seed = 0; seed < 20; ++seed) {
+        FactoryGeneratorOptions options;
+        options.ramps = 1 + static_cast<ElementID>(seed % 7);
+        options.workers = 1 + static_cast<ElementID>(seed * 13 % 200);
+        options.storehouses = 1 + static_cast<ElementID>(seed % 5);
+        options.layers = 1 + static_cast<int>(seed % 9);
+        options.fan_out = {1, 1 + static_cast<int>(seed % 4)};
+        options.seed = seed;
+        Factory factory = generate_factory(options);
+        EXPECT_TRUE(factory.is_consistent()) << "seed " << seed;
+        EXPECT_TRUE(factory.check_consistency().consistent) << "seed " << seed;
+    }
+}
+
+TEST(FactoryGeneratorTest, TextAndFactoryDescribeTheSameNetwork) {
+    FactoryGeneratorOptions options;
+    options.workers = 300;
+    options.seed = 7;
+    std::ostringstream text;
+    generate_factory_structure(options, text);
+    std::istringstream iss(text.str());
+    Factory loaded = load_factory_structure(iss);
+
+    EXPECT_EQ(structure_report(loaded), structure_report(generate_factory(options)));
+}
+
+TEST(FactoryGeneratorTest, SameSeedGivesSameNetwork) {
+    FactoryGeneratorOptions options;
+    options.seed = 11;
+    std::ostringstream first;
+    std::ostringstream second;
+    generate_factory_structure(options, first);
+    generate_factory_structure(options, second);
+    EXPECT_EQ(first.str(), second.str());
+
+    options.seed = 12;
+    std::ostringstream other;
+    generate_factory_structure(options, other);
+    EXPECT_NE(first.str(), other.str());
+}
+
+TEST(FactoryGeneratorTest, NodeParametersFollowOptions) {
+    FactoryGeneratorOptions options;
+    options.ramps = 4;
+    options.workers = 100;
+    options.storehouses = 3;
+    options.layers = 5;
+    options.fan_out = {2, 2};
+    options.lifo_fraction = 1.0;
+    options.processing_time = {2, 4};
+    options.delivery_interval = {3, 3};
+    Factory factory = generate_factory(options);
+
+    EXPECT_EQ(std::distance(factory.ramp_cbegin(), factory.ramp_cend()), 4);
+    EXPECT_EQ(std::distance(factory.worker_cbegin(), factory.worker_cend()), 100);
+    EXPECT_EQ(std::distance(factory.storehouse_cbegin(), factory.storehouse_cend()), 3);
+    for (auto it = factory.ramp_cbegin(); it != factory.ramp_cend(); ++it) {
+        EXPECT_EQ(it->get_delivery_interval(), 3);
+        EXPECT_GE(it->receiver_preferences_.get_preferences().size(), 2u);
+    }
+    for (auto it = factory.worker_cbegin(); it != factory.worker_cend(); ++it) {
+        EXPECT_EQ(it->get_queue()->get_queue_type(), PackageQueueType::LIFO);
+        EXPECT_GE(it->get_processing_duration(), 2);
+        EXPECT_LE(it->get_processing_duration(), 4);
+        EXPECT_GE(it->receiver_preferences_.get_preferences().size(), 2u);
+    }
+}
+
+TEST(FactoryGeneratorTest, InvalidOptionsThrow) {
+    FactoryGeneratorOptions options;
+    options.storehouses = 0;
+    EXPECT_THROW(generate_factory(options), std::invalid_argument);
+    options = FactoryGeneratorOptions();
+    options.fan_out = {3, 2};
+    EXPECT_THROW(generate_factory(options), std::invalid_argument);
+    options = FactoryGeneratorOptions();
+    options.lifo_fraction = 1.5;
+    std::ostringstream os;
+    EXPECT_THROW(generate_factory_structure(options, os), std::invalid_argument);
+}
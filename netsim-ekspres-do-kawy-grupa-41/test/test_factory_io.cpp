@@ -2,7 +2,10 @@
 #include "gtest/gtest.h"
 
 #include "factory.hpp"
+#include "structure_parser.hpp"
 
+#include <cstdio>
+#include <fstream>
 #include <set>
 
 //using ::testing::Return;
@@ -64,26 +67,26 @@ TEST(FactoryIOTest, ParseLinkOneReceiver) {
     EXPECT_DOUBLE_EQ(prefs[key], 1.0);
 }
 
-//TEST(FactoryIOTest, ParseLinkOneReceiverWithDefinedProbability) {
-//    std::ostringstream oss;
-//    oss << "LOADING_RAMP id=1 delivery-interval=3" << "\n"
-//        << "STOREHOUSE id=1" << "\n"
-//        << "LINK src=ramp-1 dest=store-1 p=1.0" << "\n";
-//    std::istringstream iss(oss.str());
-//    auto factory = load_factory_structure(iss);
-//
-//    ASSERT_EQ(std::next(factory.ramp_cbegin(), 1), factory.ramp_cend());
-//    const auto& r = *(factory.ramp_cbegin());
-//
-//    ASSERT_EQ(std::next(factory.storehouse_cbegin(), 1), factory.storehouse_cend());
-//    const auto& s = *(factory.storehouse_cbegin());
-//
-//    auto prefs = r.receiver_preferences_.get_preferences();
-//    ASSERT_EQ(1U, prefs.size());
-//    auto key = dynamic_cast<IPackageReceiver*>(const_cast<Storehouse*>(&s));
-//    ASSERT_NE(prefs.find(key), prefs.end());
-//    EXPECT_DOUBLE_EQ(prefs[key], 1.0);
-//}
+TEST(FactoryIOTest, ParseLinkOneReceiverWithDefinedProbability) {
+    std::ostringstream oss;
+    oss << "LOADING_RAMP id=1 delivery-interval=3" << "\n"
+        << "STOREHOUSE id=1" << "\n"
+        << "LINK src=ramp-1 dest=store-1 p=1.0" << "\n";
+    std::istringstream iss(oss.str());
+    auto factory = load_factory_structure(iss);
+
+    ASSERT_EQ(std::next(factory.ramp_cbegin(), 1), factory.ramp_cend());
+    const auto& r = *(factory.ramp_cbegin());
+
+    ASSERT_EQ(std::next(factory.storehouse_cbegin(), 1), factory.storehouse_cend());
+    const auto& s = *(factory.storehouse_cbegin());
+
+    auto prefs = r.receiver_preferences_.get_preferences();
+    ASSERT_EQ(1U, prefs.size());
+    auto key = dynamic_cast<IPackageReceiver*>(const_cast<Storehouse*>(&s));
+    ASSERT_NE(prefs.find(key), prefs.end());
+    EXPECT_DOUBLE_EQ(prefs[key], 1.0);
+}
 
 TEST(FactoryIOTest, ParseLinkMultipleReceivers) {
     std::ostringstream oss;
@@ -112,32 +115,32 @@ TEST(FactoryIOTest, ParseLinkMultipleReceivers) {
     EXPECT_DOUBLE_EQ(prefs[key2], 0.5);
 }
 
-//TEST(FactoryIOTest, ParseLinkMultipleReceiversWithDefinedProbabilities) {
-//    std::ostringstream oss;
-//    oss << "LOADING_RAMP id=1 delivery-interval=3" << "\n"
-//        << "STOREHOUSE id=1" << "\n"
-//        << "STOREHOUSE id=2" << "\n"
-//        << "LINK src=ramp-1 dest=store-1 p=0.3" << "\n"
-//        << "LINK src=ramp-1 dest=store-2 p=0.7" << "\n";
-//    std::istringstream iss(oss.str());
-//    auto factory = load_factory_structure(iss);
-//
-//    ASSERT_EQ(std::next(factory.ramp_cbegin(), 1), factory.ramp_cend());
-//    const auto& r = *(factory.ramp_cbegin());
-//
-//    ASSERT_EQ(std::next(factory.storehouse_cbegin(), 2), factory.storehouse_cend());
-//    const auto& s1 = *(factory.storehouse_cbegin());
-//    const auto& s2 = *(std::next(factory.storehouse_cbegin(), 1));
-//
-//    auto prefs = r.receiver_preferences_.get_preferences();
-//    ASSERT_EQ(2U, prefs.size());
-//    auto key1 = dynamic_cast<IPackageReceiver*>(const_cast<Storehouse*>(&s1));
-//    auto key2 = dynamic_cast<IPackageReceiver*>(const_cast<Storehouse*>(&s2));
-//    ASSERT_NE(prefs.find(key1), prefs.end());
-//    ASSERT_NE(prefs.find(key2), prefs.end());
-//    EXPECT_DOUBLE_EQ(prefs[key1], 0.3);
-//    EXPECT_DOUBLE_EQ(prefs[key2], 0.7);
-//}
+TEST(FactoryIOTest, ParseLinkMultipleReceiversWithDefinedProbabilities) {
+    std::ostringstream oss;
+    oss << "LOADING_RAMP id=1 delivery-interval=3" << "\n"
+        << "STOREHOUSE id=1" << "\n"
+        << "STOREHOUSE id=2" << "\n"
+        << "LINK src=ramp-1 dest=store-1 p=0.3" << "\n"
+        << "LINK src=ramp-1 dest=store-2 p=0.7" << "\n";
+    std::istringstream iss(oss.str());
+    auto factory = load_factory_structure(iss);
+
+    ASSERT_EQ(std::next(factory.ramp_cbegin(), 1), factory.ramp_cend());
+    const auto& r = *(factory.ramp_cbegin());
+
+    ASSERT_EQ(std::next(factory.storehouse_cbegin(), 2), factory.storehouse_cend());
+    const auto& s1 = *(factory.storehouse_cbegin());
+    const auto& s2 = *(std::next(factory.storehouse_cbegin(), 1));
+
+    auto prefs = r.receiver_preferences_.get_preferences();
+    ASSERT_EQ(2U, prefs.size());
+    auto key1 = dynamic_cast<IPackageReceiver*>(const_cast<Storehouse*>(&s1));
+    auto key2 = dynamic_cast<IPackageReceiver*>(const_cast<Storehouse*>(&s2));
+    ASSERT_NE(prefs.find(key1), prefs.end());
+    ASSERT_NE(prefs.find(key2), prefs.end());
+    EXPECT_DOUBLE_EQ(prefs[key1], 0.3);
+    EXPECT_DOUBLE_EQ(prefs[key2], 0.7);
+}
 
 TEST(FactoryIOTest, LoadAndSaveTest) {
     std::string r1 = "LOADING_RAMP id=1 delivery-interval=3";
@@ -242,4 +245,68 @@ TEST(FactoryIOTest, LoadAndSaveTest) {
     ASSERT_LT(first_ramp_it, first_worker_it);
     ASSERT_LT(first_worker_it, first_storehouse_it);
     ASSERT_LT(first_storehouse_it, first_link_it);
-}
\ No newline at end of file
+}
+
+TEST(FactoryIOTest, SavedWeightsRoundTripExactly) {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    const std::vector<double> weights = {1.0 / 3.0, 0.1, 2.0 / 7.0};
+    for (ElementID id = 1; id <= 3; ++id) {
+        factory.add_worker(Worker(id, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    }
+    for (ElementID id = 1; id <= 3; ++id) {
+        factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(id), weights[id - 1]);
+    }
+
+    std::ostringstream oss;
+    save_factory_structure(factory, oss);
+    std::istringstream iss(oss.str());
+    Factory loaded = load_factory_structure(iss);
+
+    const auto& expected = factory.find_ramp_by_id(1)->receiver_preferences_;
+    const auto& actual = loaded.find_ramp_by_id(1)->receiver_preferences_;
+    for (ElementID id = 1; id <= 3; ++id) {
+        EXPECT_EQ(actual.get_weight(&*loaded.find_worker_by_id(id)), weights[id - 1]) << id;
+    }
+    EXPECT_EQ(actual.get_alias_probabilities(), expected.get_alias_probabilities());
+    EXPECT_EQ(actual.get_aliases(), expected.get_aliases());
+}
+
+TEST(FactoryIOTest, ParseErrorsReportLineNumbers) {
+    auto error_line = [](const std::string& text) -> std::size_t {
+        try {
+            parse_factory_structure(text);
+        } catch (const StructureParseError& e) {
+            return e.line();
+        }
+        return 0;
+    };
+
+    EXPECT_EQ(error_line("; komentarz\nLOADING_RAMP id=1 delivery-interval=3\nRAMP id=2\n"), 3u);
+    EXPECT_EQ(error_line("WORKER id=1 processing-time=x queue-type=FIFO"), 1u);
+    EXPECT_EQ(error_line("WORKER id=1 processing-time=1 queue-type=PRIORITY"), 1u);
+    EXPECT_EQ(error_line("STOREHOUSE id=1\n\nLINK src=ramp-1 dest=store-1\n"), 3u);
+    EXPECT_EQ(error_line("LOADING_RAMP id=1 delivery-interval=1\nLINK src=ramp-1 dest=store-7\n"), 2u);
+    EXPECT_EQ(error_line("LOADING_RAMP id=1"), 1u);
+    EXPECT_THROW(parse_factory_structure("LINK src=ramp-1 dest"), std::logic_error);
+}
+
+TEST(FactoryIOTest, LoadFromMappedFile) {
+    std::string path = ::testing::TempDir() + "net_simulation_structure.txt";
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "; plik z koncami linii CRLF\r\n"
+                "LOADING_RAMP id=1 delivery-interval=3\r\n"
+                "WORKER id=1 processing-time=2 queue-type=LIFO\r\n"
+                "STOREHOUSE id=1\r\n"
+                "LINK src=ramp-1 dest=worker-1\r\n"
+                "LINK  src=worker-1   dest=store-1 p=0.5";
+    }
+
+    Factory factory = load_factory_structure_file(path);
+    std::remove(path.c_str());
+
+    EXPECT_EQ(factory.find_ramp_by_id(1)->get_delivery_interval(), 3);
+    EXPECT_EQ(factory.find_worker_by_id(1)->get_queue()->get_queue_type(), PackageQueueType::LIFO);
+    EXPECT_TRUE(factory.is_consistent());
+}
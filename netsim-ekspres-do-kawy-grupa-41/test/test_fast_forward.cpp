@@ -0,0 +1,130 @@
+#include "gtest/gtest.h"
+
+#include "checkpoint.hpp"
+#include "reports.hpp"
+#include "simulation.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Rampy co 3 i co 4 tury -> robotnik FIFO (2 tury) i robotnik LIFO (1 tura) -> magazyn
+const char* periodic_structure =
+        "LOADING_RAMP id=1 delivery-interval=3\n"
+        "LOADING_RAMP id=2 delivery-interval=4\n"
+        "WORKER id=1 processing-time=2 queue-type=FIFO\n"
+        "WORKER id=2 processing-time=1 queue-type=LIFO\n"
+        "STOREHOUSE id=1\n"
+        "STOREHOUSE id=2\n"
+        "LINK src=ramp-1 dest=worker-1\n"
+        "LINK src=ramp-2 dest=worker-2\n"
+        "LINK src=worker-1 dest=worker-2\n"
+        "LINK src=worker-2 dest=store-1\n";
+
+Factory load(const std::string& structure) {
+    std::istringstream iss(structure);
+    Factory factory = load_factory_structure(iss);
+    factory.seed_streams(5);
+    return factory;
+}
+
+std::string turn_report_of(const Factory& factory, Time turn) {
+    std::ostringstream oss;
+    generate_simulation_turn_report(factory, oss, turn);
+    return oss.str();
+}
+
+std::string checkpoint_of(const Factory& factory, Time turn) {
+    std::ostringstream oss;
+    save_checkpoint(factory, turn, oss);
+    return oss.str();
+}
+
+}
+
+TEST(FastForwardTest, SkipsPeriodsAndEndsInTheSameState) {
+    Factory stepped = load(periodic_structure);
+    simulate(stepped, 5000, [](Factory&, Time) {});
+
+    Factory skipped = load(periodic_structure);
+    std::vector<FastForwardSpan> spans;
+    std::vector<Time> reported;
+    simulate_fast_forward(skipped, 5000, [&reported](Factory&, Time t) { reported.push_back(t); },
+                          [&spans](Factory&, const FastForwardSpan& span) { spans.push_back(span); });
+
+    ASSERT_EQ(spans.size(), 1u);
+    EXPECT_EQ(spans[0].period % 12, 0);
+    EXPECT_LT(reported.size(), 200u);
+    EXPECT_EQ(static_cast<Time>(reported.size()) + spans[0].last_turn - spans[0].first_turn + 1, 4999);
+    EXPECT_EQ(checkpoint_of(skipped, 4999), checkpoint_of(stepped, 4999));
+}
+
+TEST(FastForwardTest, StuckPackagesKeepTheirIds) {
+//    Robotnik LIFO obciazony w pelni i z zapasem: dolne polprodukty nigdy nie wychodza, wierzch wymienia sie co okres
+    const char* structure =
+            "LOADING_RAMP id=1 delivery-interval=2\n"
+            "WORKER id=1 processing-time=2 queue-type=LIFO\n"
+            "STOREHOUSE id=1\n"
+            "LINK src=ramp-1 dest=worker-1\n"
+            "LINK src=worker-1 dest=store-1\n";
+    Factory stepped = load(structure);
+    Factory skipped = load(structure);
+    for (Factory* f: {&stepped, &skipped}) {
+        for (int i = 0; i < 3; ++i) {
+            f->find_worker_by_id(1)->receive_package(Package(f->get_context()));
+        }
+    }
+    simulate(stepped, 3000, [](Factory&, Time) {});
+    std::size_t skips = 0;
+    simulate_fast_forward(skipped, 3000, [](Factory&, Time) {}, [&skips](Factory&, const FastForwardSpan&) { ++skips; });
+
+    EXPECT_EQ(skips, 1u);
+    EXPECT_EQ(checkpoint_of(skipped, 2999), checkpoint_of(stepped, 2999));
+}
+
+TEST(FastForwardTest, GrowingQueueIsNotPeriodic) {
+    const char* overloaded =
+            "LOADING_RAMP id=1 delivery-interval=1\n"
+            "WORKER id=1 processing-time=2 queue-type=FIFO\n"
+            "STOREHOUSE id=1\n"
+            "LINK src=ramp-1 dest=worker-1\n"
+            "LINK src=worker-1 dest=store-1\n";
+    Factory stepped = load(overloaded);
+    simulate(stepped, 500, [](Factory&, Time) {});
+    Factory skipped = load(overloaded);
+    std::size_t reports = 0;
+    simulate_fast_forward(skipped, 500, [&reports](Factory&, Time) { ++reports; },
+                          [](Factory&, const FastForwardSpan&) { FAIL() << "przeskok dla rosnacej kolejki"; });
+
+    EXPECT_EQ(reports, 499u);
+    EXPECT_EQ(checkpoint_of(skipped, 499), checkpoint_of(stepped, 499));
+}
+
+TEST(FastForwardTest, RandomRoutingIsNotSkipped) {
+    auto structure = std::string(periodic_structure) + "LINK src=worker-1 dest=store-2\n";
+    Factory factory = load(structure);
+    EXPECT_FALSE(PeriodicFastForward(factory).is_applicable());
+    EXPECT_TRUE(PeriodicFastForward(*std::make_unique<Factory>(load(periodic_structure))).is_applicable());
+
+    Factory stepped = load(structure);
+    simulate(stepped, 300, [](Factory&, Time) {});
+    simulate_fast_forward(factory, 300, [](Factory&, Time) {}, [](Factory&, const FastForwardSpan&) { FAIL(); });
+//    Kolejnosc odbiorcow w punkcie kontrolnym zalezy od adresow wezlow, wiec porownywany jest raport tury
+    EXPECT_EQ(turn_report_of(factory, 299), turn_report_of(stepped, 299));
+}
+
+TEST(FastForwardTest, ReportSummarizesSkippedSpan) {
+    FastForwardSpan span{10, 109, 4, 25, 50, {{2, 0}, {1, 50}}};
+    std::ostringstream oss;
+    generate_fast_forward_report(span, oss);
+    EXPECT_EQ(oss.str(),
+              "=== [ Turns: 10-109 (fast-forward) ] ===\n\n"
+              "Period: 4 turns x 25\n"
+              "Packages delivered: 50\n\n"
+              "== STOREHOUSES ==\n\n"
+              "STOREHOUSE #1\n  Received: 50\n\n"
+              "STOREHOUSE #2\n  Received: 0\n\n");
+}
@@ -0,0 +1,71 @@
+#include "gtest/gtest.h"
+
+#include "id_allocator.hpp"
+
+#include <vector>
+
+TEST(IdAllocatorTest, AssignsConsecutiveIds) {
+    IdAllocator allocator;
+
+    EXPECT_EQ(allocator.allocate(), 1);
+    EXPECT_EQ(allocator.allocate(), 2);
+    EXPECT_EQ(allocator.allocate(), 3);
+}
+
+TEST(IdAllocatorTest, ReusesLowestFreedId) {
+    IdAllocator allocator;
+    for (int i = 0; i < 5; ++i) {
+        allocator.allocate();
+    }
+    allocator.release(4);
+    allocator.release(2);
+
+    EXPECT_EQ(allocator.allocate(), 2);
+    EXPECT_EQ(allocator.allocate(), 4);
+    EXPECT_EQ(allocator.allocate(), 6);
+}
+
+TEST(IdAllocatorTest, ReleasingUnassignedIdExtendsRange) {
+    // Tak jak wczesniej: zniszczenie polproduktu z recznie nadanym ID dopisuje je do puli wolnych.
+    IdAllocator allocator;
+    allocator.release(10);
+
+    EXPECT_EQ(allocator.allocate(), 10);
+    EXPECT_EQ(allocator.allocate(), 11);
+}
+
+TEST(IdAllocatorTest, ReusesLowestFreedIdAcrossBitmapLevels) {
+    IdAllocator allocator;
+    const ElementID n = 300000;
+    for (ElementID i = 1; i <= n; ++i) {
+        allocator.allocate();
+    }
+    std::vector<ElementID> freed{n, 250000, 4097, 64, 63, 1};
+    for (auto id: freed) {
+        allocator.release(id);
+    }
+
+    for (auto it = freed.rbegin(); it != freed.rend(); ++it) {
+        EXPECT_EQ(allocator.allocate(), *it);
+    }
+    EXPECT_FALSE(allocator.has_freed_ids());
+    EXPECT_EQ(allocator.allocate(), n + 1);
+}
+
+TEST(IdAllocatorTest, RestoresSavedState) {
+    IdAllocator allocator;
+    for (int i = 0; i < 200; ++i) {
+        allocator.allocate();
+    }
+    allocator.release(150);
+    allocator.release(3);
+    allocator.release(70);
+
+    IdAllocator restored;
+    restored.restore(allocator.get_next_fresh_id(), allocator.get_freed_ids());
+
+    EXPECT_EQ(restored.get_freed_ids(), (std::vector<ElementID>{3, 70, 150}));
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_EQ(restored.allocate(), allocator.allocate());
+    }
+}
@@ -0,0 +1,175 @@
+#include "gtest/gtest.h"
+
+#include "checkpoint.hpp"
+#include "latency.hpp"
+#include "simulation.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <string>
+
+static_assert(package_latency_enabled, "Testy opoznien wymagaja WITH_PACKAGE_LATENCY");
+
+namespace {
+
+// Rampa 1 co 3 tury do robotnika (3 tury pracy) i dalej do magazynu; rampa 2 prosto do magazynu.
+const char* latency_test_structure =
+        "LOADING_RAMP id=1 delivery-interval=3\n"
+        "LOADING_RAMP id=2 delivery-interval=2\n"
+        "WORKER id=1 processing-time=3 queue-type=FIFO\n"
+        "STOREHOUSE id=1\n"
+        "LINK src=ramp-1 dest=worker-1\n"
+        "LINK src=ramp-2 dest=store-1\n"
+        "LINK src=worker-1 dest=store-1\n";
+
+Factory load_latency_test_factory() {
+    std::istringstream iss(latency_test_structure);
+    return load_factory_structure(iss);
+}
+
+}
+
+TEST(LatencyHistogramTest, SmallValuesAreExact) {
+    LatencyHistogram h;
+    for (std::uint32_t v = 0; v < 2 * LatencyHistogram::sub_bucket_count; ++v) {
+        h.record(v);
+    }
+    EXPECT_EQ(h.count(), 64u);
+    EXPECT_EQ(h.min(), 0u);
+    EXPECT_EQ(h.max(), 63u);
+    EXPECT_EQ(h.percentile(0.5), 31u);
+    EXPECT_EQ(h.percentile(1.0), 63u);
+    EXPECT_DOUBLE_EQ(h.mean(), 31.5);
+}
+
+TEST(LatencyHistogramTest, BucketsCoverValuesWithBoundedRelativeError) {
+    std::size_t previous = 0;
+    for (std::uint64_t v = 0; v <= std::numeric_limits<std::uint32_t>::max(); v = v < 4096 ? v + 1 : v + v / 7) {
+        auto value = static_cast<std::uint32_t>(v);
+        std::size_t index = LatencyHistogram::bucket_index(value);
+        ASSERT_LT(index, LatencyHistogram::bucket_count);
+        ASSERT_GE(index, previous);
+        std::uint32_t upper = LatencyHistogram::bucket_upper_bound(index);
+        ASSERT_GE(upper, value);
+        ASSERT_LE(static_cast<double>(upper - value), static_cast<double>(value) / LatencyHistogram::sub_bucket_count);
+        previous = index;
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_index(std::numeric_limits<std::uint32_t>::max()), LatencyHistogram::bucket_count - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesOfUniformValues) {
+    LatencyHistogram h;
+    for (std::uint32_t v = 1; v <= 10000; ++v) {
+        h.record(v);
+    }
+    auto expect_close = [](std::uint32_t actual, double expected) {
+        EXPECT_GE(actual, expected);
+        EXPECT_LE(actual, expected * (1.0 + 1.0 / LatencyHistogram::sub_bucket_count));
+    };
+    expect_close(h.percentile(0.5), 5000);
+    expect_close(h.percentile(0.99), 9900);
+    expect_close(h.percentile(0.999), 9990);
+    EXPECT_EQ(h.percentile(1.0), 10000u);
+}
+
+TEST(LatencyHistogramTest, MergeAddsCounts) {
+    LatencyHistogram a;
+    LatencyHistogram b;
+    a.record(10);
+    b.record(2);
+    b.record(500);
+    a.merge(b);
+    EXPECT_EQ(a.count(), 3u);
+    EXPECT_EQ(a.min(), 2u);
+    EXPECT_EQ(a.max(), 500u);
+    EXPECT_EQ(a.percentile(0.5), 10u);
+}
+
+TEST(LatencyTest, AgeIsNeverNegative) {
+    SimulationContext context;
+    context.set_turn(2);
+    Storehouse storehouse(1);
+    Package package(context);
+    package.stamp_birth(5, 1);
+    EXPECT_EQ(package.get_age(), 0);
+
+    storehouse.receive_package(std::move(package));
+    EXPECT_EQ(storehouse.get_latency().get_total().max(), 0u);
+}
+
+TEST(LatencyTest, StorehouseRecordsLatencyPerRamp) {
+    Factory factory = load_latency_test_factory();
+    simulate(factory, 30, [](Factory&, Time) {});
+
+    const LatencyRecorder& latency = factory.find_storehouse_by_id(1)->get_latency();
+    const auto& paths = latency.get_paths();
+    ASSERT_EQ(paths.size(), 2u);
+//    Przez robotnika: dostawa w turze t, koniec pracy w t + 2, przekazanie w t + 3
+    EXPECT_EQ(paths.at(1).min(), 3u);
+    EXPECT_EQ(paths.at(1).max(), 3u);
+    EXPECT_EQ(paths.at(2).percentile(0.999), 0u);
+    EXPECT_EQ(latency.get_total().count(), paths.at(1).count() + paths.at(2).count());
+    EXPECT_EQ(paths.at(2).count(), 15u);
+}
+
+TEST(LatencyTest, AllSimulationLoopsAgree) {
+    Factory stepped = load_latency_test_factory();
+    simulate(stepped, 30, [](Factory&, Time) {});
+    Factory event_driven = load_latency_test_factory();
+    simulate_event_driven(event_driven, 30, [](Factory&, Time) {});
+    Factory compiled_source = load_latency_test_factory();
+    CompiledFactory compiled(compiled_source);
+    simulate(compiled, 30, [](Factory&, Time) {});
+
+    const auto& expected = stepped.find_storehouse_by_id(1)->get_latency().get_total();
+    for (const Factory* f: {&event_driven, &compiled_source}) {
+        const auto& actual = f->find_storehouse_by_id(1)->get_latency().get_total();
+        EXPECT_EQ(actual.count(), expected.count());
+        EXPECT_DOUBLE_EQ(actual.mean(), expected.mean());
+        EXPECT_EQ(actual.max(), expected.max());
+    }
+}
+
+TEST(LatencyTest, CheckpointKeepsPackageStamps) {
+//    Po turze 11 polprodukty z rampy 1 sa w kolejce i buforach robotnika, a w magazynie juz kilka przyjetych
+    Factory original = load_latency_test_factory();
+    simulate(original, 12, [](Factory&, Time) {});
+    std::stringstream checkpoint_data;
+    save_checkpoint(original, 11, checkpoint_data);
+    LatencyRecorder before = original.find_storehouse_by_id(1)->get_latency();
+    simulate_from(original, 12, 40, [](Factory&, Time) {});
+
+    Checkpoint restored = load_checkpoint(checkpoint_data);
+    simulate_from(restored.factory, restored.turn + 1, 40, [](Factory&, Time) {});
+
+//    Histogramy nie sa zapisywane, wiec po dolaczeniu pomiarow sprzed zapisu musza byc takie jak bez przerwy
+    const LatencyRecorder& expected = original.find_storehouse_by_id(1)->get_latency();
+    const LatencyRecorder& resumed = restored.factory.find_storehouse_by_id(1)->get_latency();
+    ASSERT_EQ(resumed.get_paths().size(), expected.get_paths().size());
+    for (const auto& [origin, histogram]: expected.get_paths()) {
+        LatencyHistogram merged = before.get_paths().at(origin);
+        merged.merge(resumed.get_paths().at(origin));
+        EXPECT_EQ(merged.count(), histogram.count()) << origin;
+        EXPECT_EQ(merged.min(), histogram.min()) << origin;
+        EXPECT_EQ(merged.max(), histogram.max()) << origin;
+        EXPECT_DOUBLE_EQ(merged.mean(), histogram.mean()) << origin;
+    }
+    LatencyHistogram merged = before.get_total();
+    merged.merge(resumed.get_total());
+    EXPECT_EQ(merged.count(), expected.get_total().count());
+    EXPECT_EQ(merged.percentile(0.5), expected.get_total().percentile(0.5));
+}
+
+TEST(LatencyTest, SummaryIsWrittenAtEndOfSimulation) {
+    std::ostringstream oss;
+    metrics_summary_output = &oss;
+    Factory factory = load_latency_test_factory();
+    simulate(factory, 30, [](Factory&, Time) {});
+    metrics_summary_output = nullptr;
+
+    std::string summary = oss.str();
+    EXPECT_EQ(summary.rfind("== PACKAGE LATENCY ==", 0), 0u);
+    EXPECT_NE(summary.find("ramp-1"), std::string::npos);
+    EXPECT_NE(summary.find("ramp-2"), std::string::npos);
+}
@@ -0,0 +1,142 @@
+#include "gtest/gtest.h"
+
+#include "metrics.hpp"
+#include "simulation.hpp"
+
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static_assert(node_metrics_enabled, "Testy metryk wymagaja WITH_NODE_METRICS");
+
+namespace {
+
+const char* metrics_test_structure =
+        "LOADING_RAMP id=1 delivery-interval=2\n"
+        "LOADING_RAMP id=2 delivery-interval=5\n"
+        "WORKER id=1 processing-time=3 queue-type=FIFO\n"
+        "WORKER id=2 processing-time=1 queue-type=LIFO\n"
+        "WORKER id=3 processing-time=4 queue-type=FIFO\n"
+        "STOREHOUSE id=1\n"
+        "LINK src=ramp-1 dest=worker-1\n"
+        "LINK src=ramp-1 dest=worker-2\n"
+        "LINK src=ramp-2 dest=worker-3\n"
+        "LINK src=worker-1 dest=worker-3\n"
+        "LINK src=worker-1 dest=store-1\n"
+        "LINK src=worker-2 dest=store-1\n"
+        "LINK src=worker-3 dest=store-1\n";
+
+template <class Simulation>
+std::vector<NodeMetrics> run_collecting(Simulation simulation) {
+    std::istringstream iss(metrics_test_structure);
+    Factory factory = load_factory_structure(iss);
+    factory.seed_streams(3);
+    simulation(factory);
+    std::vector<NodeMetrics> metrics;
+    for (auto it = factory.ramp_cbegin(); it != factory.ramp_cend(); ++it) {
+        metrics.push_back(it->get_metrics());
+    }
+    for (auto it = factory.worker_cbegin(); it != factory.worker_cend(); ++it) {
+        metrics.push_back(it->get_metrics());
+    }
+    for (auto it = factory.storehouse_cbegin(); it != factory.storehouse_cend(); ++it) {
+        metrics.push_back(it->get_metrics());
+    }
+    return metrics;
+}
+
+void expect_same(const std::vector<NodeMetrics>& actual, const std::vector<NodeMetrics>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(actual[i].busy_turns, expected[i].busy_turns) << "node " << i;
+        EXPECT_EQ(actual[i].idle_turns, expected[i].idle_turns) << "node " << i;
+        EXPECT_EQ(actual[i].packages_in, expected[i].packages_in) << "node " << i;
+        EXPECT_EQ(actual[i].packages_out, expected[i].packages_out) << "node " << i;
+        EXPECT_EQ(actual[i].queue_length_area, expected[i].queue_length_area) << "node " << i;
+        EXPECT_EQ(actual[i].max_queue_length, expected[i].max_queue_length) << "node " << i;
+    }
+}
+
+}
+
+TEST(MetricsTest, WorkerCountsTurnsAndQueue) {
+    Worker worker(1, 2, std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    for (ElementID id = 1; id <= 3; ++id) {
+        worker.receive_package(Package(id));
+    }
+    for (Time t = 1; t <= 7; ++t) {
+        worker.do_work(t);
+        if (worker.get_sending_buffer()) {
+            worker.release_sending_buffer();
+        }
+    }
+
+    NodeMetrics m = worker.get_metrics();
+    EXPECT_EQ(m.busy_turns, 6);
+    EXPECT_EQ(m.idle_turns, 1);
+    EXPECT_EQ(m.packages_in, 3u);
+    EXPECT_EQ(m.packages_out, 3u);
+    EXPECT_EQ(m.max_queue_length, 3u);
+    // Czekajace w kolejnych turach: 2, 2, 1, 1, 0, 0, 0
+    EXPECT_EQ(m.queue_length_area, 6u);
+    EXPECT_DOUBLE_EQ(m.mean_queue_length(), 6.0 / 7.0);
+    EXPECT_DOUBLE_EQ(m.utilization(), 6.0 / 7.0);
+}
+
+TEST(MetricsTest, SkippedTurnsUseStateAtEndOfLastTurn) {
+    Worker worker(1, 10, std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    worker.receive_package(Package(1));
+    worker.receive_package(Package(2));
+    worker.do_work(1);
+    worker.do_work(5);
+
+    NodeMetrics m = worker.get_metrics();
+    EXPECT_EQ(m.busy_turns, 5);
+    EXPECT_EQ(m.idle_turns, 0);
+    EXPECT_EQ(m.queue_length_area, 5u);
+}
+
+TEST(MetricsTest, AllSimulationLoopsAgree) {
+    auto expected = run_collecting([](Factory& f) { simulate(f, 100, [](Factory&, Time) {}); });
+    EXPECT_GT(expected[2].busy_turns, 0);
+
+    expect_same(run_collecting([](Factory& f) { simulate_event_driven(f, 100, [](Factory&, Time) {}); }), expected);
+    expect_same(run_collecting([](Factory& f) {
+        CompiledFactory compiled(f);
+        simulate(compiled, 100, [](Factory&, Time) {});
+    }), expected);
+    ThreadPool pool(2);
+    expect_same(run_collecting([&pool](Factory& f) { simulate(f, 100, [](Factory&, Time) {}, pool); }), expected);
+}
+
+TEST(MetricsTest, EventDrivenCountsTurnsAfterLastEvent) {
+    // Ostatnie zdarzenie (przekazanie do magazynu) w turze 6, symulacja konczy sie na turze 8
+    auto run = [](auto simulation) {
+        std::istringstream iss("LOADING_RAMP id=1 delivery-interval=4\n"
+                               "WORKER id=1 processing-time=1 queue-type=FIFO\n"
+                               "STOREHOUSE id=1\n"
+                               "LINK src=ramp-1 dest=worker-1\n"
+                               "LINK src=worker-1 dest=store-1\n");
+        Factory factory = load_factory_structure(iss);
+        simulation(factory);
+        return factory.worker_cbegin()->get_metrics();
+    };
+    NodeMetrics expected = run([](Factory& f) { simulate(f, 9, [](Factory&, Time) {}); });
+    EXPECT_EQ(expected.busy_turns, 2);
+    EXPECT_EQ(expected.idle_turns, 6);
+
+    expect_same({run([](Factory& f) { simulate_event_driven(f, 9, [](Factory&, Time) {}); })}, {expected});
+}
+
+TEST(MetricsTest, SummaryIsWrittenAtEndOfSimulation) {
+    std::ostringstream oss;
+    metrics_summary_output = &oss;
+    run_collecting([](Factory& f) { simulate(f, 20, [](Factory&, Time) {}); });
+    metrics_summary_output = nullptr;
+
+    std::string summary = oss.str();
+    EXPECT_EQ(summary.rfind("== NODE METRICS ==", 0), 0u);
+    EXPECT_NE(summary.find("worker"), std::string::npos);
+    EXPECT_NE(summary.find("storehouse"), std::string::npos);
+}
@@ -85,6 +85,75 @@ TEST(ReceiverPreferencesTest, RemoveReceiversRescalesProbability) {
     EXPECT_EQ(rp.get_preferences().at(&r1), 1.0);
 }
 
+TEST(ReceiverPreferencesTest, WeightsAreNormalized) {
+    ReceiverPreferences rp;
+
+    MockReceiver r1, r2;
+    rp.add_receiver(&r1, 1.0);
+    rp.add_receiver(&r2, 3.0);
+    EXPECT_DOUBLE_EQ(rp.get_preferences().at(&r1), 0.25);
+    EXPECT_DOUBLE_EQ(rp.get_preferences().at(&r2), 0.75);
+    EXPECT_FALSE(rp.is_uniform());
+
+    rp.remove_receiver(&r2);
+    EXPECT_DOUBLE_EQ(rp.get_preferences().at(&r1), 1.0);
+}
+
+TEST(ReceiverPreferencesTest, ChooseReceiverFollowsWeights) {
+    // Rownomiernie rozlozone liczby z [0, 1) - liczba wyborow kazdego odbiorcy musi odpowiadac jego wadze.
+    const int draws = 1000;
+    int k = 0;
+    ReceiverPreferences rp([&k]() { return (k++ + 0.5) / draws; });
+
+    MockReceiver r1, r2, r3;
+    rp.add_receiver(&r1, 1.0);
+    rp.add_receiver(&r2, 3.0);
+    rp.add_receiver(&r3, 6.0);
+
+    std::map<IPackageReceiver*, int> counts;
+    for (int i = 0; i < draws; ++i) {
+        counts[rp.choose_receiver()]++;
+    }
+    EXPECT_EQ(counts[&r1], 100);
+    EXPECT_EQ(counts[&r2], 300);
+    EXPECT_EQ(counts[&r3], 600);
+}
+
+TEST(ReceiverPreferencesTest, EqualWeightsPickFloorOfScaledNumber) {
+    // Granica u = k / n nalezy do odbiorcy k (dawne przejscie po sumach wybieralo odbiorce k - 1).
+    double u = 0.0;
+    ReceiverPreferences rp([&u]() { return u; });
+
+    MockReceiver r1, r2, r3, r4;
+    for (auto receiver: {&r1, &r2, &r3, &r4}) {
+        rp.add_receiver(receiver);
+    }
+    const auto& receivers = rp.get_receivers();
+    for (std::size_t k = 0; k < receivers.size(); ++k) {
+        u = static_cast<double>(k) / 4.0;
+        EXPECT_EQ(rp.choose_receiver(), receivers[k]) << k;
+        u = (static_cast<double>(k) + 0.5) / 4.0;
+        EXPECT_EQ(rp.choose_receiver(), receivers[k]) << k;
+    }
+    u = 1.0;
+    EXPECT_EQ(rp.choose_receiver(), receivers.back());
+}
+
+TEST(ReceiverPreferencesTest, GeneratorAsTemplatePolicy) {
+    BasicReceiverPreferences<RandomStream> rp(RandomStream(11, 3));
+    ReceiverPreferences reference(RandomStream(11, 3));
+
+    MockReceiver r1, r2, r3;
+    for (auto receiver: {&r1, &r2, &r3}) {
+        rp.add_receiver(receiver);
+        reference.add_receiver(receiver);
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(rp.choose_receiver(), reference.choose_receiver());
+    }
+}
+
 // Przydatny alias, żeby zamiast pisać `::testing::Return(...)` móc pisać
 // samo `Return(...)`.
 using ::testing::Return;
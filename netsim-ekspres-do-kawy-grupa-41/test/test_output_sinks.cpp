@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+
+#include "factory_generator.hpp"
+#include "output_sinks.hpp"
+#include "simulation.hpp"
+
+#include <algorithm>
+#include <ios>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+// Rampa (co ture) -> robotnik (2 tury) -> magazyn
+Factory make_line_factory() {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_worker(Worker(1, 2, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_storehouse(Storehouse(1));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1));
+    factory.find_worker_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    return factory;
+}
+
+Factory make_generated_factory() {
+    FactoryGeneratorOptions options;
+    options.ramps = 3;
+    options.workers = 20;
+    options.storehouses = 2;
+    options.layers = 3;
+    options.seed = 4;
+    Factory factory = generate_factory(options);
+    factory.seed_streams(4);
+    return factory;
+}
+
+std::vector<std::string> lines_of(const std::string& text) {
+    std::vector<std::string> lines;
+    std::istringstream iss(text);
+    for (std::string line; std::getline(iss, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// Zapamietuje rekordy przekazane przez TurnOutputSink
+class RecordingSink : public TurnOutputSink {
+public:
+    explicit RecordingSink(std::ostream& os) : TurnOutputSink(os) {}
+    std::vector<NodeTurnRecord> records;
+
+protected:
+    void write_record(const NodeTurnRecord& record) override { records.push_back(record); }
+};
+
+auto as_tuple(const NodeTurnRecord& r) {
+    return std::make_tuple(r.turn, r.kind, r.id, r.queue_length, r.processing_id, r.sending_id, r.stock_count);
+}
+
+}
+
+TEST(OutputSinksTest, JsonLinesWritesOneObjectPerTurn) {
+    Factory factory = make_line_factory();
+    std::ostringstream oss;
+    {
+        JsonLinesSink sink(oss);
+        simulate(factory, 5, std::ref(sink));
+    }
+    auto lines = lines_of(oss.str());
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[0], "{\"turn\":1,\"nodes\":[{\"kind\":\"worker\",\"id\":1,\"queue\":0,\"processing\":1,\"sending\":null},"
+                        "{\"kind\":\"storehouse\",\"id\":1,\"stock\":0}]}");
+    EXPECT_EQ(lines[3], "{\"turn\":4,\"nodes\":[{\"kind\":\"worker\",\"id\":1,\"queue\":2,\"processing\":null,\"sending\":2},"
+                        "{\"kind\":\"storehouse\",\"id\":1,\"stock\":1}]}");
+}
+
+TEST(OutputSinksTest, CsvWritesOneRowPerNodeAndTurn) {
+    Factory factory = make_line_factory();
+    std::ostringstream oss;
+    {
+        CsvSink sink(oss);
+        simulate(factory, 4, std::ref(sink));
+    }
+    auto lines = lines_of(oss.str());
+    ASSERT_EQ(lines.size(), 7u);
+    EXPECT_EQ(lines[0], "turn,kind,id,queue_length,processing_id,sending_id,stock_count");
+    EXPECT_EQ(lines[1], "1,worker,1,0,1,,");
+    EXPECT_EQ(lines[2], "1,storehouse,1,,,,0");
+    EXPECT_EQ(lines[5], "3,worker,1,1,2,,");
+}
+
+TEST(OutputSinksTest, ColumnarRoundTripsAcrossBlocks) {
+    std::ostringstream ignored;
+    RecordingSink recording(ignored);
+    Factory recorded = make_generated_factory();
+    simulate(recorded, 50, std::ref(recording));
+
+    std::ostringstream oss;
+    {
+        ColumnarSink sink(oss, 7);
+        Factory factory = make_generated_factory();
+        simulate(factory, 50, std::ref(sink));
+    }
+    std::istringstream iss(oss.str());
+    auto records = read_columnar_output(iss);
+    ASSERT_EQ(records.size(), recording.records.size());
+    ASSERT_EQ(records.size(), 49u * 22u);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        ASSERT_EQ(as_tuple(records[i]), as_tuple(recording.records[i])) << i;
+    }
+}
+
+TEST(OutputSinksTest, ColumnarRejectsDamagedInput) {
+    std::ostringstream oss;
+    {
+        ColumnarSink sink(oss);
+        Factory factory = make_line_factory();
+        simulate(factory, 10, std::ref(sink));
+    }
+    std::string data = oss.str();
+    std::istringstream truncated(data.substr(0, data.size() - 3));
+    EXPECT_THROW(read_columnar_output(truncated), std::runtime_error);
+    std::istringstream foreign("NSCP" + data.substr(4));
+    EXPECT_THROW(read_columnar_output(foreign), std::runtime_error);
+
+//    Liczba wierszy pierwszego bloku (za magia i wersja) zamieniona na ogromna
+    std::string huge_count = data;
+    const std::size_t header = 8;
+    std::fill(huge_count.begin() + header, huge_count.begin() + header + 4, '\xff');
+    std::istringstream huge(huge_count);
+    EXPECT_THROW(read_columnar_output(huge), std::runtime_error);
+}
+
+TEST(OutputSinksTest, ReportsWriteErrors) {
+    Factory factory = make_line_factory();
+    for (auto format: {OutputFormat::JSONL, OutputFormat::CSV, OutputFormat::COLUMNAR}) {
+        std::ostringstream oss;
+        oss.setstate(std::ios::badbit);
+        auto sink = make_output_sink(format, oss);
+        sink->write(factory, 1);
+        EXPECT_THROW(sink->flush(), std::ios_base::failure);
+        sink->write(factory, 2);
+//        Destruktor konczy zapis bez wyjatku
+        EXPECT_NO_THROW(sink.reset());
+    }
+
+//    Bufor mniejszy od rekordu - oprozniany juz w write()
+    std::ostringstream oss;
+    oss.setstate(std::ios::badbit);
+    JsonLinesSink sink(oss, 1);
+    EXPECT_THROW(sink.write(factory, 1), std::ios_base::failure);
+}
+
+TEST(OutputSinksTest, FormatIsSelectedByName) {
+    EXPECT_EQ(parse_output_format("jsonl"), OutputFormat::JSONL);
+    EXPECT_EQ(parse_output_format("csv"), OutputFormat::CSV);
+    EXPECT_EQ(parse_output_format("columnar"), OutputFormat::COLUMNAR);
+    EXPECT_THROW(parse_output_format("xml"), std::invalid_argument);
+
+    std::ostringstream oss;
+    {
+        auto sink = make_output_sink(parse_output_format("csv"), oss);
+        Factory factory = make_line_factory();
+        simulate(factory, 2, std::ref(*sink));
+    }
+    EXPECT_EQ(lines_of(oss.str()).size(), 3u);
+}
@@ -39,3 +39,20 @@ TEST(PackageTest, IsAssignmentOperatorCorrect) {
 
     EXPECT_EQ(p2.get_id(), 1);
 }
+
+TEST(PackageTest, ContextsHaveSeparateIds) {
+    SimulationContext first;
+    SimulationContext second;
+
+    Package p1(first);
+    Package p2(second);
+    {
+        Package p3(first);
+        EXPECT_EQ(p3.get_id(), 2);
+    }
+    Package p4(first);
+
+    EXPECT_EQ(p1.get_id(), 1);
+    EXPECT_EQ(p2.get_id(), 1);
+    EXPECT_EQ(p4.get_id(), 2);
+}
@@ -0,0 +1,63 @@
+#include "gtest/gtest.h"
+
+#include "random.hpp"
+
+#include <vector>
+
+TEST(PhiloxTest, MatchesReferenceVectors) {
+    // Wektory kontrolne z biblioteki Random123 (kat_vectors)
+    EXPECT_EQ(Philox4x32::generate({0, 0, 0, 0}, {0, 0}),
+              (Philox4x32::counter_t{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}));
+    EXPECT_EQ(Philox4x32::generate({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}),
+              (Philox4x32::counter_t{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}));
+    EXPECT_EQ(Philox4x32::generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+              (Philox4x32::counter_t{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}));
+}
+
+TEST(RandomStreamTest, SameSeedAndStreamGiveSameSequence) {
+    RandomStream a(42, 7);
+    RandomStream b(42, 7);
+    RandomStream other_stream(42, 8);
+    RandomStream other_seed(43, 7);
+
+    bool differs_by_stream = false;
+    bool differs_by_seed = false;
+    for (std::size_t i = 0; i < 3 * RandomStream::batch_size; ++i) {
+        double x = a();
+        EXPECT_EQ(x, b());
+        EXPECT_GE(x, 0.0);
+        EXPECT_LT(x, 1.0);
+        differs_by_stream |= x != other_stream();
+        differs_by_seed |= x != other_seed();
+    }
+    EXPECT_TRUE(differs_by_stream);
+    EXPECT_TRUE(differs_by_seed);
+}
+
+TEST(RandomStreamTest, SeekResumesSequence) {
+    RandomStream stream(5, 1);
+    std::vector<double> values;
+    for (int i = 0; i < 200; ++i) {
+        values.push_back(stream());
+    }
+    EXPECT_EQ(stream.get_position(), 200u);
+
+    RandomStream resumed(5, 1);
+    resumed.seek(70);
+    EXPECT_EQ(resumed.get_position(), 70u);
+    for (std::size_t i = 70; i < values.size(); ++i) {
+        EXPECT_EQ(resumed(), values[i]);
+    }
+}
+
+TEST(RandomStreamTest, IsRoughlyUniform) {
+    RandomStream stream(2021);
+    const int draws = 100000;
+    std::vector<int> buckets(10, 0);
+    for (int i = 0; i < draws; ++i) {
+        buckets[static_cast<std::size_t>(stream() * 10)]++;
+    }
+    for (int count: buckets) {
+        EXPECT_NEAR(count, draws / 10, draws / 100);
+    }
+}
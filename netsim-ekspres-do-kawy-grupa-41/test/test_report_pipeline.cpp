@@ -0,0 +1,137 @@
+#include "gtest/gtest.h"
+
+#include "factory_generator.hpp"
+#include "report_pipeline.hpp"
+#include "simulation.hpp"
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+namespace {
+
+Factory make_factory() {
+    FactoryGeneratorOptions options;
+    options.ramps = 4;
+    options.workers = 40;
+    options.storehouses = 3;
+    options.layers = 4;
+    options.seed = 11;
+    Factory factory = generate_factory(options);
+    factory.seed_streams(3);
+    return factory;
+}
+
+template <class Notifier>
+std::string reported_synchronously(Notifier& notifier) {
+    Factory factory = make_factory();
+    std::ostringstream oss;
+    simulate(factory, 300, [&](Factory& f, Time t) {
+        if (notifier.should_generate_report(t)) {
+            generate_simulation_turn_report(f, oss, t);
+        }
+    });
+    return oss.str();
+}
+
+// Rampa dostarczajaca w kazdej turze prosto do magazynu
+Factory make_line_to_storehouse(std::unique_ptr<IPackageStockpile> stockpile) {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 1));
+    factory.add_storehouse(Storehouse(1, std::move(stockpile)));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    return factory;
+}
+
+// Zapis wolniejszy od symulacji
+class SlowBuffer : public std::stringbuf {
+protected:
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return std::stringbuf::xsputn(s, n);
+    }
+};
+
+}
+
+TEST(ReportPipelineTest, MatchesSynchronousReports) {
+    IntervalReportNotifier notifier(3);
+    const std::string expected = reported_synchronously(notifier);
+
+    for (std::size_t slots: {1, 2, 8}) {
+        Factory factory = make_factory();
+        std::ostringstream oss;
+        ReportPipeline pipeline(oss, slots);
+        simulate(factory, 300, make_pipeline_report_function(pipeline, notifier));
+        pipeline.drain();
+        EXPECT_EQ(oss.str(), expected) << slots;
+    }
+}
+
+TEST(ReportPipelineTest, FollowsSpecificTurnsInEventDrivenSimulation) {
+    SpecificTurnsReportNotifier notifier({1, 2, 50, 51, 150, 299});
+    const std::string expected = reported_synchronously(notifier);
+
+    Factory factory = make_factory();
+    std::ostringstream oss;
+    ReportPipeline pipeline(oss);
+    simulate_event_driven(factory, 300, std::ref(pipeline), make_report_schedule(notifier));
+    pipeline.drain();
+    EXPECT_EQ(oss.str(), expected);
+}
+
+TEST(ReportPipelineTest, StallsWhenWriterFallsBehind) {
+    IntervalReportNotifier notifier(1);
+    const std::string expected = reported_synchronously(notifier);
+
+    SlowBuffer buffer;
+    std::ostream os(&buffer);
+    Factory factory = make_factory();
+    {
+        ReportPipeline pipeline(os, 2);
+        simulate(factory, 300, make_pipeline_report_function(pipeline, notifier));
+        EXPECT_GT(pipeline.get_stall_count(), 0u);
+    }
+    EXPECT_EQ(buffer.str(), expected);
+}
+
+TEST(ReportPipelineTest, RethrowsWriteErrors) {
+    std::ostringstream oss;
+    oss.setstate(std::ios::badbit);
+    Factory factory = make_factory();
+    ReportPipeline pipeline(oss);
+    pipeline.submit(factory, 1);
+    EXPECT_THROW(pipeline.drain(), std::ios_base::failure);
+    EXPECT_NO_THROW(pipeline.drain());
+}
+
+TEST(ReportPipelineTest, ReadsSpilledStockAtWriteTime) {
+    const Time turns = 3 * static_cast<Time>(RetainingStockpile::spill_batch_size);
+    IntervalReportNotifier notifier(4000);
+    Factory queued = make_line_to_storehouse(std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    std::ostringstream expected;
+    simulate(queued, turns, [&](Factory& f, Time t) {
+        if (notifier.should_generate_report(t)) {
+            generate_simulation_turn_report(f, expected, t);
+        }
+    });
+
+    Factory spilled = make_line_to_storehouse(std::make_unique<RetainingStockpile>(RetentionPolicy::SPILL, 10));
+    std::ostringstream oss;
+    {
+        ReportPipeline pipeline(oss, 2);
+        simulate(spilled, turns, make_pipeline_report_function(pipeline, notifier));
+        pipeline.drain();
+    }
+    EXPECT_EQ(oss.str(), expected.str());
+
+//    Zrzut trzyma tylko polprodukty z pamieci magazynu
+    TurnSnapshot snapshot;
+    snapshot.capture(spilled, turns - 1);
+    ASSERT_EQ(snapshot.get_storehouses().size(), 1u);
+    EXPECT_EQ(snapshot.get_storehouses()[0].spilled, 2 * RetainingStockpile::spill_batch_size);
+    EXPECT_LT(snapshot.get_ids().size(), 10 + RetainingStockpile::spill_batch_size);
+}
@@ -208,6 +208,48 @@ TEST(ReportsTest, TurnReportNoPackages) {
     perform_turn_report_check(factory, t, expected_report_lines);
 }
 
+TEST(ReportsTest, TurnReportWriterFollowsStructureChanges) {
+    Factory factory;
+    factory.add_worker(Worker(2, 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_storehouse(Storehouse(1));
+
+    TurnReportWriter writer;
+    std::ostringstream first;
+    writer.write(factory, first, 1);
+
+    factory.add_worker(Worker(1, 1, std::make_unique<PackageQueue>(PackageQueueType::LIFO)));
+    factory.find_worker_by_id(1)->receive_package(Package(7));
+    factory.find_worker_by_id(1)->receive_package(Package(3));
+    std::ostringstream second;
+    writer.write(factory, second, 2);
+
+    std::vector<std::string> expected_report_lines{
+            "=== [ Turn: 2 ] ===",
+            "",
+            "== WORKERS ==",
+            "",
+            "WORKER #1",
+            "  PBuffer: (empty)",
+            "  Queue: #7, #3",
+            "  SBuffer: (empty)",
+            "",
+            "WORKER #2",
+            "  PBuffer: (empty)",
+            "  Queue: (empty)",
+            "  SBuffer: (empty)",
+            "",
+            "",
+            "== STOREHOUSES ==",
+            "",
+            "STOREHOUSE #1",
+            "  Stock: (empty)",
+            "",
+    };
+    std::function<void(std::ostringstream&)> reporting_function = [&second](std::ostringstream& oss) { oss << second.str(); };
+    perform_report_check(reporting_function, expected_report_lines);
+    EXPECT_EQ(first.str().find("WORKER #1"), std::string::npos);
+}
+
 TEST(ReportsTest, TurnReportPackageInProcessingBuffer) {
     // Utwórz fabrykę.
     Factory factory;
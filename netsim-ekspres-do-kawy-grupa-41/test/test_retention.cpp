@@ -0,0 +1,181 @@
+#include "gtest/gtest.h"
+
+#include "simulation.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <class Stock>
+std::vector<ElementID> ids_of(const Stock& stock) {
+    std::vector<ElementID> ids;
+    for (const auto& package: stock) {
+        ids.push_back(package.get_id());
+    }
+    return ids;
+}
+
+std::vector<ElementID> range(ElementID first, ElementID last) {
+    std::vector<ElementID> ids;
+    for (ElementID id = first; id <= last; ++id) {
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+// Rampa (co 2 tury) -> robotnik (2 tury) -> magazyn z podana polityka - stan ustalony juz po kilku turach
+Factory make_factory(std::unique_ptr<IPackageStockpile> stockpile) {
+    Factory factory;
+    factory.add_ramp(Ramp(1, 2));
+    factory.add_worker(Worker(1, 2, std::make_unique<PackageQueue>(PackageQueueType::FIFO)));
+    factory.add_storehouse(Storehouse(1, std::move(stockpile)));
+    factory.find_ramp_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_worker_by_id(1));
+    factory.find_worker_by_id(1)->receiver_preferences_.add_receiver(&*factory.find_storehouse_by_id(1));
+    return factory;
+}
+
+std::string simulated_reports(Factory& factory, TimeOffset d) {
+    std::ostringstream oss;
+    simulate(factory, d, [&oss](Factory& f, Time t) { generate_simulation_turn_report(f, oss, t); });
+    return oss.str();
+}
+
+}
+
+TEST(RetentionTest, CountOnlyKeepsIdsReserved) {
+    SimulationContext context;
+    RetainingStockpile stockpile(RetentionPolicy::COUNT_ONLY, 10);
+    for (int i = 0; i < 5; ++i) {
+        stockpile.push(Package(context));
+    }
+    EXPECT_EQ(stockpile.received_count(), 5u);
+    EXPECT_TRUE(stockpile.empty());
+    EXPECT_EQ(stockpile.cbegin(), stockpile.cend());
+    EXPECT_FALSE(context.id_allocator().has_freed_ids());
+    EXPECT_EQ(Package(context).get_id(), 6);
+}
+
+TEST(RetentionTest, KeepLastKeepsNewestInOrder) {
+    SimulationContext context;
+    RetainingStockpile stockpile(RetentionPolicy::KEEP_LAST, 3);
+    for (int i = 0; i < 10; ++i) {
+        stockpile.push(Package(context));
+    }
+    EXPECT_EQ(stockpile.received_count(), 10u);
+    EXPECT_EQ(stockpile.size(), 3u);
+    EXPECT_EQ(ids_of(stockpile), range(8, 10));
+}
+
+TEST(RetentionTest, SpillMovesOldestToFileInBatches) {
+    SimulationContext context;
+    RetainingStockpile stockpile(RetentionPolicy::SPILL, 100);
+    const ElementID count = 10000;
+    for (ElementID i = 0; i < count; ++i) {
+        stockpile.push(Package(context));
+    }
+    EXPECT_EQ(stockpile.received_count(), static_cast<std::uint64_t>(count));
+    EXPECT_EQ(stockpile.stored_count(), static_cast<std::size_t>(count));
+    EXPECT_EQ(stockpile.size(), ids_of(stockpile).size());
+
+//    Dwie pelne partie w pliku, reszta (co najmniej `keep`) w pamieci
+    const PackageIdRange spilled = stockpile.spilled_ids();
+    EXPECT_EQ(spilled.size(), 2 * RetainingStockpile::spill_batch_size);
+    std::vector<ElementID> ids(spilled.begin(), spilled.end());
+    for (ElementID id: ids_of(stockpile)) {
+        ids.push_back(id);
+    }
+    EXPECT_EQ(ids, range(1, count));
+}
+
+TEST(RetentionTest, SpillFileHoldsDroppedIds) {
+    const std::string path = ::testing::TempDir() + "net_simulation_retention_test.bin";
+    {
+        SimulationContext context;
+        RetainingStockpile stockpile(RetentionPolicy::SPILL, 2, path);
+        for (int i = 0; i < 5; ++i) {
+            stockpile.push(Package(context));
+        }
+    }
+    std::ifstream file(path, std::ios::binary);
+    std::vector<ElementID> ids(4, 0);
+    file.read(reinterpret_cast<char*>(ids.data()), static_cast<std::streamsize>(ids.size() * sizeof(ElementID)));
+    EXPECT_EQ(file.gcount(), static_cast<std::streamsize>(3 * sizeof(ElementID)));
+    EXPECT_EQ(std::vector<ElementID>(ids.begin(), ids.begin() + 3), range(1, 3));
+    std::remove(path.c_str());
+}
+
+TEST(RetentionTest, FlushSpillsEverythingAboveKeep) {
+    SimulationContext context;
+    RetainingStockpile stockpile(RetentionPolicy::SPILL, 2);
+    for (int i = 0; i < 5; ++i) {
+        stockpile.push(Package(context));
+    }
+    stockpile.flush();
+    EXPECT_EQ(stockpile.size(), 2u);
+    EXPECT_EQ(stockpile.stored_count(), 5u);
+    const PackageIdRange spilled = stockpile.spilled_ids();
+    EXPECT_EQ(std::vector<ElementID>(spilled.begin(), spilled.end()), range(1, 3));
+    EXPECT_EQ(ids_of(stockpile), range(4, 5));
+}
+
+TEST(RetentionTest, RestoringSpilledIdsNeedsSpillPolicy) {
+    RetainingStockpile stockpile(RetentionPolicy::KEEP_LAST, 2);
+    EXPECT_THROW(stockpile.restore_spilled_ids({1, 2}), std::logic_error);
+}
+
+TEST(RetentionTest, PolicyDoesNotChangeSimulation) {
+    Factory kept = make_factory(std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    Factory spilled = make_factory(std::make_unique<RetainingStockpile>(RetentionPolicy::SPILL, 4));
+    Factory counted = make_factory(std::make_unique<RetainingStockpile>(RetentionPolicy::COUNT_ONLY));
+
+    const std::string reports = simulated_reports(kept, 300);
+    EXPECT_EQ(simulated_reports(spilled, 300), reports);
+    simulate(counted, 300, [](Factory&, Time) {});
+
+    const auto& store = *counted.find_storehouse_by_id(1);
+    EXPECT_EQ(store.get_received_count(), kept.find_storehouse_by_id(1)->get_received_count());
+    EXPECT_EQ(store.cbegin(), store.cend());
+    EXPECT_EQ(counted.get_context().id_allocator().get_next_fresh_id(), kept.get_context().id_allocator().get_next_fresh_id());
+}
+
+TEST(RetentionTest, ReportListsSpilledStock) {
+    Factory kept = make_factory(std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    Factory spilled = make_factory(std::make_unique<RetainingStockpile>(RetentionPolicy::SPILL, 10));
+    const TimeOffset turns = 2 * static_cast<TimeOffset>(RetainingStockpile::spill_batch_size) + 100;
+    auto last_report = [](Factory& factory, TimeOffset d) {
+        std::ostringstream oss;
+        simulate(factory, d, [&oss, d](Factory& f, Time t) {
+            if (t == d - 1) {
+                generate_simulation_turn_report(f, oss, t);
+            }
+        });
+        return oss.str();
+    };
+
+    const std::string report = last_report(kept, turns);
+    EXPECT_EQ(last_report(spilled, turns), report);
+    EXPECT_FALSE(spilled.find_storehouse_by_id(1)->spilled_ids().empty());
+}
+
+TEST(RetentionTest, FastForwardStopsWhenStockIsDropped) {
+    Factory spilled = make_factory(std::make_unique<RetainingStockpile>(RetentionPolicy::SPILL, 5));
+    int spill_skips = 0;
+    simulate_fast_forward(spilled, 500, [](Factory&, Time) {}, [&spill_skips](Factory&, const FastForwardSpan&) { ++spill_skips; });
+    EXPECT_EQ(spill_skips, 1);
+
+    Factory stepped = make_factory(std::make_unique<RetainingStockpile>(RetentionPolicy::KEEP_LAST, 1));
+    Factory skipped = make_factory(std::make_unique<RetainingStockpile>(RetentionPolicy::KEEP_LAST, 1));
+    simulate(stepped, 500, [](Factory&, Time) {});
+    int skips = 0;
+    simulate_fast_forward(skipped, 500, [](Factory&, Time) {}, [&skips](Factory&, const FastForwardSpan&) { ++skips; });
+
+    EXPECT_EQ(skips, 0);
+    EXPECT_EQ(ids_of(*skipped.find_storehouse_by_id(1)), ids_of(*stepped.find_storehouse_by_id(1)));
+    EXPECT_EQ(ids_of(*spilled.find_storehouse_by_id(1)).size(), skipped.find_storehouse_by_id(1)->get_received_count());
+}
@@ -6,6 +6,10 @@
 #include "helpers.hpp"
 #include "reports.hpp"
 
+#include <memory>
+#include <random>
+#include <sstream>
+
 using ::testing::Return;
 using ::testing::_;
 
@@ -35,3 +39,115 @@ TEST(SimulationTest, Simulate) {
     ASSERT_NE(storehouse_it->cbegin(), storehouse_it->cend());
     EXPECT_EQ(storehouse_it->cbegin()->get_id(), 1);
 }
+
+namespace {
+
+// Kilka ramp o roznych odstepach dostaw, robotnicy FIFO/LIFO o roznych czasach przetwarzania
+// i rozgalezienia z wagami - tak, by w symulacji wystepowaly zarowno tury puste, jak i zatory.
+const char* event_test_structure =
+        "LOADING_RAMP id=1 delivery-interval=3\n"
+        "LOADING_RAMP id=2 delivery-interval=7\n"
+        "LOADING_RAMP id=3 delivery-interval=20\n"
+        "WORKER id=1 processing-time=2 queue-type=FIFO\n"
+        "WORKER id=2 processing-time=5 queue-type=LIFO\n"
+        "WORKER id=3 processing-time=1 queue-type=FIFO\n"
+        "WORKER id=4 processing-time=9 queue-type=LIFO\n"
+        "STOREHOUSE id=1\n"
+        "STOREHOUSE id=2\n"
+        "LINK src=ramp-1 dest=worker-1\n"
+        "LINK src=ramp-1 dest=worker-2 p=2\n"
+        "LINK src=ramp-2 dest=worker-2\n"
+        "LINK src=ramp-3 dest=worker-4\n"
+        "LINK src=worker-1 dest=worker-3\n"
+        "LINK src=worker-1 dest=store-1\n"
+        "LINK src=worker-2 dest=worker-3\n"
+        "LINK src=worker-2 dest=worker-4\n"
+        "LINK src=worker-3 dest=store-2\n"
+        "LINK src=worker-3 dest=worker-1\n"
+        "LINK src=worker-4 dest=store-1\n";
+
+template <class Simulation>
+std::string run_reported(Simulation simulation) {
+    // Kazda fabryka dostaje wlasny generator o tym samym ziarnie.
+    auto engine = std::make_shared<std::mt19937>(2021);
+    ProbabilityGenerator previous = probability_generator;
+    probability_generator = [engine]() { return std::generate_canonical<double, 10>(*engine); };
+    std::istringstream iss(event_test_structure);
+    Factory factory = load_factory_structure(iss);
+    probability_generator = previous;
+
+    std::ostringstream oss;
+    simulation(factory, [&oss](Factory& f, Time t) { generate_simulation_turn_report(f, oss, t); });
+    return oss.str();
+}
+
+}
+
+TEST(SimulationTest, EventDrivenMatchesTurnStepped) {
+    std::string expected = run_reported([](Factory& f, auto rf) { simulate(f, 200, rf); });
+    std::string actual = run_reported([](Factory& f, auto rf) { simulate_event_driven(f, 200, rf); });
+
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(SimulationTest, ParallelMatchesSequential) {
+    std::string expected = run_reported([](Factory& f, auto rf) { simulate(f, 200, rf); });
+    for (std::size_t threads : {1, 2, 4}) {
+        ThreadPool pool(threads);
+        std::string actual = run_reported([&pool](Factory& f, auto rf) { simulate(f, 200, rf, pool); });
+
+        EXPECT_EQ(actual, expected) << "threads=" << threads;
+    }
+}
+
+TEST(SimulationTest, CompiledMatchesTurnStepped) {
+    std::string expected = run_reported([](Factory& f, auto rf) { simulate(f, 200, rf); });
+    std::string actual = run_reported([](Factory& f, auto rf) {
+        CompiledFactory compiled(f);
+        simulate(compiled, 200, rf);
+    });
+
+    EXPECT_EQ(actual, expected);
+}
+
+TEST(SimulationTest, SeededStreamsAreReproducible) {
+    auto run_seeded = [](std::uint64_t seed, auto simulation) {
+        return run_reported([seed, simulation](Factory& f, auto rf) {
+            f.seed_streams(seed);
+            simulation(f, rf);
+        });
+    };
+    auto sequential = [](Factory& f, auto rf) { simulate(f, 200, rf); };
+    ThreadPool pool(3);
+    auto parallel = [&pool](Factory& f, auto rf) { simulate(f, 200, rf, pool); };
+
+    std::string expected = run_seeded(5, sequential);
+    EXPECT_EQ(run_seeded(5, sequential), expected);
+    EXPECT_EQ(run_seeded(5, parallel), expected);
+    EXPECT_NE(run_seeded(6, sequential), expected);
+}
+
+TEST(SimulationTest, EventDrivenReportsOnNotifierTurns) {
+    IntervalReportNotifier interval(7);
+    SpecificTurnsReportNotifier specific({1, 2, 50, 51, 150});
+
+    std::string expected_interval = run_reported([&interval](Factory& f, auto rf) {
+        simulate(f, 200, [&](Factory& g, Time t) { if (interval.should_generate_report(t)) rf(g, t); });
+    });
+    std::string actual_interval = run_reported([&interval](Factory& f, auto rf) {
+        simulate_event_driven(f, 200, rf, make_report_schedule(interval));
+    });
+    EXPECT_EQ(actual_interval, expected_interval);
+    std::string temporary_interval = run_reported([](Factory& f, auto rf) {
+        simulate_event_driven(f, 200, rf, make_report_schedule(IntervalReportNotifier(7)));
+    });
+    EXPECT_EQ(temporary_interval, expected_interval);
+
+    std::string expected_specific = run_reported([&specific](Factory& f, auto rf) {
+        simulate(f, 200, [&](Factory& g, Time t) { if (specific.should_generate_report(t)) rf(g, t); });
+    });
+    std::string actual_specific = run_reported([&specific](Factory& f, auto rf) {
+        simulate_event_driven(f, 200, rf, make_report_schedule(specific));
+    });
+    EXPECT_EQ(actual_specific, expected_specific);
+}
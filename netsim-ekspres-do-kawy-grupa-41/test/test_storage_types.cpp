@@ -31,3 +31,53 @@ TEST(PackageQueueTest, IsLifoCorrect) {
     p = q.pop();
     EXPECT_EQ(p.get_id(), 1);
 }
+
+TEST(PackageQueueTest, KeepsOrderAcrossBufferGrowth) {
+    // Bufor cykliczny: poczatek kolejki "zawija sie" zanim tablica zostanie powiekszona.
+    PackageQueue q(PackageQueueType::FIFO);
+    ElementID next_in = 1;
+    ElementID next_out = 1;
+    for (int round = 0; round < 10; ++round) {
+        for (int i = 0; i < 7; ++i) {
+            q.push(Package(next_in++));
+        }
+        for (int i = 0; i < 4; ++i) {
+            EXPECT_EQ(q.pop().get_id(), next_out++);
+        }
+    }
+    ASSERT_EQ(q.size(), static_cast<std::size_t>(next_in - next_out));
+
+    ElementID expected = next_out;
+    for (auto it = q.cbegin(); it != q.cend(); ++it) {
+        EXPECT_EQ(it->get_id(), expected++);
+    }
+    EXPECT_EQ(expected, next_in);
+}
+
+TEST(PackageQueueTest, StaticQueuesKeepOrder) {
+    FifoQueue fifo;
+    LifoQueue lifo;
+    for (ElementID id = 1; id <= 3; ++id) {
+        fifo.push(Package(id));
+        lifo.push(Package(id + 10));
+    }
+    static_assert(FifoQueue::get_queue_type() == PackageQueueType::FIFO);
+    static_assert(LifoQueue::get_queue_type() == PackageQueueType::LIFO);
+
+    EXPECT_EQ(fifo.pop().get_id(), 1);
+    EXPECT_EQ(lifo.pop().get_id(), 13);
+    EXPECT_EQ(fifo.size(), 2u);
+    EXPECT_EQ(lifo.cbegin()->get_id(), 11);
+}
+
+TEST(PackageQueueTest, AdapterExposesStaticQueue) {
+    PackageQueue q(PackageQueueType::LIFO);
+    q.push(Package(1));
+
+    auto* lifo = std::get_if<LifoQueue>(&q.get_static_queue());
+    ASSERT_NE(lifo, nullptr);
+    lifo->push(Package(2));
+    EXPECT_EQ(q.size(), 2u);
+    EXPECT_EQ(q.get_queue_type(), PackageQueueType::LIFO);
+    EXPECT_EQ(q.pop().get_id(), 2);
+}
@@ -0,0 +1,64 @@
+#include "gtest/gtest.h"
+
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPoolTest, VisitsEveryIndexOnce) {
+    ThreadPool pool(4);
+    std::vector<int> visits(1000, 0);
+
+    pool.parallel_for(visits.size(), [&visits](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            visits[i]++;
+        }
+    }, 7);
+
+    EXPECT_EQ(std::accumulate(visits.begin(), visits.end(), 0), 1000);
+    EXPECT_EQ(*std::min_element(visits.begin(), visits.end()), 1);
+}
+
+TEST(ThreadPoolTest, CanBeReusedManyTimes) {
+    ThreadPool pool(3);
+    std::atomic<std::size_t> sum{0};
+
+    for (int round = 0; round < 200; ++round) {
+        pool.parallel_for(64, [&sum](std::size_t begin, std::size_t end) {
+            sum += end - begin;
+        }, 1);
+    }
+
+    EXPECT_EQ(sum.load(), 200u * 64u);
+}
+
+TEST(ThreadPoolTest, SingleThreadRunsInCaller) {
+    ThreadPool pool(1);
+    EXPECT_EQ(pool.size(), 1u);
+
+    std::size_t calls = 0;
+    pool.parallel_for(100, [&calls](std::size_t begin, std::size_t end) {
+        calls++;
+        EXPECT_EQ(begin, 0u);
+        EXPECT_EQ(end, 100u);
+    });
+    EXPECT_EQ(calls, 1u);
+}
+
+TEST(ThreadPoolTest, RethrowsExceptionFromBody) {
+    ThreadPool pool(4);
+
+    EXPECT_THROW(pool.parallel_for(100, [](std::size_t begin, std::size_t) {
+        if (begin == 50) {
+            throw std::runtime_error("blad");
+        }
+    }, 10), std::runtime_error);
+
+    // Po wyjatku pula nadal dziala
+    std::atomic<std::size_t> sum{0};
+    pool.parallel_for(10, [&sum](std::size_t begin, std::size_t end) { sum += end - begin; }, 1);
+    EXPECT_EQ(sum.load(), 10u);
+}
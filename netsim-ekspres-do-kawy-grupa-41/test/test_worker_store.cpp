@@ -0,0 +1,58 @@
+#include "gtest/gtest.h"
+
+#include "worker_store.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+TEST(WorkerStoreTest, LoadsWorkerState) {
+    Worker idle(1, 3, std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    Worker busy(2, 3, std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+    busy.receive_package(Package(7));
+    busy.do_work(5);
+
+    WorkerStore store;
+    store.resize(2);
+    store.load(0, idle);
+    store.load(1, busy);
+
+    EXPECT_EQ(store.get_busy(), (std::vector<std::uint8_t>{0, 1}));
+    EXPECT_EQ(store.get_start_times()[1], 5);
+    EXPECT_EQ(store.get_processing_durations()[1], 3);
+    EXPECT_EQ(store.get_processing_package_ids(), (std::vector<ElementID>{WorkerStore::no_package, 7}));
+    EXPECT_EQ(store.get_sending_package_ids()[1], WorkerStore::no_package);
+}
+
+TEST(WorkerStoreTest, MarkFinishedMatchesWorkerRule) {
+    // Liczba robotnikow niepodzielna przez szerokosc wektora - sprawdzana jest tez czesc skalarna
+    const std::size_t n = 301;
+    std::vector<Worker> workers;
+    workers.reserve(n);
+    std::uint64_t lcg = 11;
+    auto next = [&lcg](int bound) {
+        lcg = lcg * 6364136223846793005ULL + 1442695040888963407ULL;
+        return static_cast<int>((lcg >> 33) % static_cast<std::uint64_t>(bound));
+    };
+    WorkerStore store;
+    store.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        workers.emplace_back(static_cast<ElementID>(i + 1), next(6) + 1, std::make_unique<PackageQueue>(PackageQueueType::FIFO));
+        if (next(3) != 0) {
+            workers.back().receive_package(Package(static_cast<ElementID>(i + 1)));
+            workers.back().do_work(next(10) + 1);
+        }
+        store.load(i, workers.back());
+    }
+
+    std::vector<std::uint8_t> finished(n);
+    for (Time t = 1; t <= 16; ++t) {
+        store.mark_finished(t, finished.data());
+        for (std::size_t i = 0; i < n; ++i) {
+            const Worker& w = workers[i];
+            bool expected = w.get_processing_buffer().has_value()
+                    and t - w.get_package_processing_start_time() >= w.get_processing_duration() - 1;
+            ASSERT_EQ(finished[i], expected ? 1 : 0) << "t=" << t << " i=" << i;
+        }
+    }
+}
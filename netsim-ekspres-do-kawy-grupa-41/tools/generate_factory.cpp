@@ -0,0 +1,65 @@
+// Generator duzych fabryk do testow skali - wypisuje strukture w formacie load_factory_structure() na stdout.
+//
+// Uzycie: net_simulation__generate [--ramps N] [--workers N] [--storehouses N] [--layers N]
+//             [--fan-out MIN:MAX] [--lifo-fraction F] [--processing-time MIN:MAX]
+//             [--delivery-interval MIN:MAX] [--seed S]
+
+#include "factory_generator.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+UniformRange parse_range(const std::string& text) {
+    auto colon = text.find(':');
+    if (colon == std::string::npos) {
+        int value = std::stoi(text);
+        return {value, value};
+    }
+    return {std::stoi(text.substr(0, colon)), std::stoi(text.substr(colon + 1))};
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    FactoryGeneratorOptions options;
+    try {
+        for (int i = 1; i < argc; i += 2) {
+            const std::string flag = argv[i];
+            if (i + 1 >= argc) {
+                throw std::invalid_argument("brak wartosci dla " + flag);
+            }
+            const std::string value = argv[i + 1];
+            if (flag == "--ramps") {
+                options.ramps = std::stoi(value);
+            } else if (flag == "--workers") {
+                options.workers = std::stoi(value);
+            } else if (flag == "--storehouses") {
+                options.storehouses = std::stoi(value);
+            } else if (flag == "--layers") {
+                options.layers = std::stoi(value);
+            } else if (flag == "--fan-out") {
+                options.fan_out = parse_range(value);
+            } else if (flag == "--lifo-fraction") {
+                options.lifo_fraction = std::stod(value);
+            } else if (flag == "--processing-time") {
+                options.processing_time = parse_range(value);
+            } else if (flag == "--delivery-interval") {
+                options.delivery_interval = parse_range(value);
+            } else if (flag == "--seed") {
+                options.seed = std::stoull(value);
+            } else {
+                throw std::invalid_argument("nieznana opcja " + flag);
+            }
+        }
+        std::ios::sync_with_stdio(false);
+        generate_factory_structure(options, std::cout);
+    } catch (const std::exception& e) {
+        std::cerr << "net_simulation__generate: " << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}